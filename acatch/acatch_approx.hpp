@@ -0,0 +1,214 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+//-----------------------------------------------------------------------------
+/// Tolerance of a floating point comparison. Two values match when they are
+/// equal or when any of the tolerances accepts them:
+/// |a - b| <= margin, |a - b| <= epsilon * max( |a|, |b| ) or when they are at
+/// most ulps representable values apart. NaN never matches.
+class ACATCH_API Tolerance
+{
+public:
+  Tolerance()
+      : mEpsilon( std::numeric_limits<float>::epsilon() * 100 )
+      , mMargin( 0 )
+      , mUlps( 0 ) {
+  }
+
+  /// Relative tolerance
+  Tolerance& epsilon( double aEpsilon ) {
+    mEpsilon = aEpsilon;
+    return *this;
+  }
+
+  /// Absolute tolerance
+  Tolerance& margin( double aMargin ) {
+    mMargin = aMargin;
+    return *this;
+  }
+
+  /// Distance in units in the last place, counted in the type of the compared values
+  Tolerance& ulps( uint64_t aUlps ) {
+    mUlps = aUlps;
+    return *this;
+  }
+
+  double getEpsilon() const {
+    return mEpsilon;
+  }
+
+  double getMargin() const {
+    return mMargin;
+  }
+
+  uint64_t getUlps() const {
+    return mUlps;
+  }
+
+  bool matches( float aLhs, float aRhs ) const;
+  bool matches( double aLhs, double aRhs ) const;
+
+  std::string toString() const;
+
+private:
+  double mEpsilon;
+  double mMargin;
+  uint64_t mUlps;
+};
+
+//-----------------------------------------------------------------------------
+/// A value compared with a tolerance: x == Approx( 1.0 ).epsilon( 1e-6 ).
+/// A float compared with an Approx is compared as float, the other arithmetic
+/// types as double.
+class ACATCH_API Approx
+{
+public:
+  explicit Approx( double aValue, const Tolerance& aTolerance = Tolerance() )
+      : mValue( aValue )
+      , mTolerance( aTolerance ) {
+  }
+
+  Approx& epsilon( double aEpsilon ) {
+    mTolerance.epsilon( aEpsilon );
+    return *this;
+  }
+
+  Approx& margin( double aMargin ) {
+    mTolerance.margin( aMargin );
+    return *this;
+  }
+
+  Approx& ulps( uint64_t aUlps ) {
+    mTolerance.ulps( aUlps );
+    return *this;
+  }
+
+  bool matches( float aValue ) const {
+    return mTolerance.matches( aValue, static_cast<float>( mValue ) );
+  }
+
+  template <typename T>
+  bool matches( const T& aValue ) const {
+    return mTolerance.matches( static_cast<double>( aValue ), mValue );
+  }
+
+  double getValue() const {
+    return mValue;
+  }
+
+  const Tolerance& getTolerance() const {
+    return mTolerance;
+  }
+
+  template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+  friend bool operator==( const T& aLhs, const Approx& aRhs ) {
+    return aRhs.matches( aLhs );
+  }
+
+  template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+  friend bool operator==( const Approx& aLhs, const T& aRhs ) {
+    return aLhs.matches( aRhs );
+  }
+
+  template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+  friend bool operator!=( const T& aLhs, const Approx& aRhs ) {
+    return !aRhs.matches( aLhs );
+  }
+
+  template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+  friend bool operator!=( const Approx& aLhs, const T& aRhs ) {
+    return !aLhs.matches( aRhs );
+  }
+
+private:
+  double mValue;
+  Tolerance mTolerance;
+};
+
+ACATCH_API std::string toString( const Approx& aApprox );
+
+namespace Detail {
+
+/// Summary of the element wise comparison of two floating point ranges
+struct ApproxRangeStats {
+  uint64_t count;    ///< elements out of tolerance
+  size_t first;      ///< index of the first element out of tolerance
+  size_t worst;      ///< index of the largest absolute error, NaN counts as infinite
+  double worstError;
+};
+
+/// Compare aSize elements, the kernels are vectorized
+ACATCH_API void approxRange( const float* aLhs, const float* aRhs, size_t aSize, const Tolerance& aTolerance, ApproxRangeStats& aStats );
+ACATCH_API void approxRange( const double* aLhs, const double* aRhs, size_t aSize, const Tolerance& aTolerance, ApproxRangeStats& aStats );
+
+ACATCH_API std::string approxRangeToString( double aLhsFirst, double aRhsFirst, double aLhsWorst, double aRhsWorst,
+                                            bool aIsFloat, size_t aLhsSize, size_t aRhsSize,
+                                            const ApproxRangeStats& aStats, const Tolerance& aTolerance );
+
+} // namespace Detail
+
+//-----------------------------------------------------------------------------
+/// Result of the comparison of two float or double ranges with a tolerance,
+/// with the number of elements out of tolerance and the worst error.
+template <typename T>
+class RangeApproxComparison
+{
+public:
+  static_assert( std::is_same<T, float>::value || std::is_same<T, double>::value, "only float and double ranges are supported" );
+
+  RangeApproxComparison( const T* aLhs, size_t aLhsSize, const T* aRhs, size_t aRhsSize, const Tolerance& aTolerance )
+      : mLhs( aLhs )
+      , mRhs( aRhs )
+      , mLhsSize( aLhsSize )
+      , mRhsSize( aRhsSize )
+      , mTolerance( aTolerance ) {
+    Detail::approxRange( aLhs, aRhs, aLhsSize < aRhsSize ? aLhsSize : aRhsSize, aTolerance, mStats );
+  }
+
+  explicit operator bool() const {
+    return mStats.count == 0 && mLhsSize == mRhsSize;
+  }
+
+  const Detail::ApproxRangeStats& getStats() const {
+    return mStats;
+  }
+
+  std::string toString() const {
+    bool any = mStats.count > 0;
+    bool anyElement = mLhsSize > 0 && mRhsSize > 0;
+    return Detail::approxRangeToString( any ? mLhs[ mStats.first ] : 0, any ? mRhs[ mStats.first ] : 0,
+                                        anyElement ? mLhs[ mStats.worst ] : 0, anyElement ? mRhs[ mStats.worst ] : 0,
+                                        std::is_same<T, float>::value, mLhsSize, mRhsSize, mStats, mTolerance );
+  }
+
+private:
+  const T* mLhs;
+  const T* mRhs;
+  size_t mLhsSize;
+  size_t mRhsSize;
+  Tolerance mTolerance;
+  Detail::ApproxRangeStats mStats;
+};
+
+template <typename T>
+std::string toString( const RangeApproxComparison<T>& aComparison ) {
+  return aComparison.toString();
+}
+
+/// Compare two contiguous float or double ranges element by element with a tolerance
+template <typename L, typename R>
+RangeApproxComparison<typename Detail::RangeElement<L>::type> rangeApprox( const L& aLhs, const R& aRhs, const Tolerance& aTolerance = Tolerance() ) {
+  typedef typename Detail::RangeElement<L>::type T;
+  static_assert( std::is_same<T, typename Detail::RangeElement<R>::type>::value, "the ranges must have the same element type" );
+  return RangeApproxComparison<T>( Detail::rangeData( aLhs ), Detail::rangeSize( aLhs ), Detail::rangeData( aRhs ), Detail::rangeSize( aRhs ),
+                                   aTolerance );
+}
+
+} // namespace ACatch
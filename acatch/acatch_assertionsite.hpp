@@ -0,0 +1,115 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+/// On ELF platforms pointers to the sites are collected in a section, so the
+/// sites never reached can be reported too. The section holds pointers as the
+/// compiler may over-align the sites themselves.
+#if defined( __GNUC__ ) && defined( __ELF__ )
+#  define ACATCH_INTERNAL_HAS_SITE_SECTION
+#  define ACATCH_INTERNAL_SITE_ENTRY( site )                                   \
+  static ::ACatch::AssertionSite* const acatch_internal_siteEntry              \
+    __attribute__( ( used, section( "acatch_sites" ) ) ) = &site;
+#else
+#  define ACATCH_INTERNAL_SITE_ENTRY( site )
+#endif
+
+namespace ACatch {
+
+//-----------------------------------------------------------------------------
+/// Static descriptor of an assertion, one for each expansion of the assertion
+/// macros. It is constant initialized, reaching it costs the load of its
+/// registration flag. The hits are counted only on request (--sites) as the
+/// counter of a site is shared by all the threads checking it.
+struct ACATCH_API AssertionSite
+{
+  constexpr AssertionSite( const char* aFile, uint aLine, const char* aKind, const char* aExpression )
+      : file( aFile )
+      , line( aLine )
+      , kind( aKind )
+      , expression( aExpression )
+      , registered( false )
+      , hits( 0 )
+      , fails( 0 )
+      , firstFailure( nullptr )
+      , next( nullptr ) {
+  }
+
+  AssertionSite( const AssertionSite& ) = delete;
+  AssertionSite& operator=( const AssertionSite& ) = delete;
+
+  void hit() {
+    if( !registered.load( std::memory_order_relaxed ) )
+      registerSite();
+    if( countingHits().load( std::memory_order_relaxed ) )
+      hits.fetch_add( 1, std::memory_order_relaxed );
+  }
+
+  void fail( const std::string& aValues ) {
+    fails.fetch_add( 1, std::memory_order_relaxed );
+    if( !firstFailure.load( std::memory_order_acquire ) )
+      recordFirstFailure( aValues );
+  }
+
+  /// True once the site has been reached by this process
+  bool isReached() const {
+    return registered.load( std::memory_order_relaxed );
+  }
+
+  /// Number of evaluations while the hits are counted
+  uint64_t getHits() const {
+    return hits.load( std::memory_order_relaxed );
+  }
+
+  uint64_t getFails() const {
+    return fails.load( std::memory_order_relaxed );
+  }
+
+  /// Add the counts of a run in a forked process, which reached the site.
+  /// aFirstFailure is the first failure of the run, nullptr if none.
+  void addCounts( uint64_t aHits, uint64_t aFails, const std::string* aFirstFailure );
+
+  static void setCountHits( bool aCount ) {
+    countingHits().store( aCount, std::memory_order_relaxed );
+  }
+
+  static bool isCountingHits() {
+    return countingHits().load( std::memory_order_relaxed );
+  }
+
+  /// The expanded values of the first failure, empty if the site never failed
+  std::string getFirstFailure() const;
+
+  /// "file:line"
+  std::string location() const;
+
+  /// The sites reached by this process sorted by location. On ELF platforms
+  /// the sites never reached are included too.
+  static std::vector<const AssertionSite*> getAll();
+
+  const char* file;
+  uint line;
+  const char* kind;       ///< type of the check: EXPECT, ASSERT_FAST...
+  const char* expression; ///< the checked expressions as written
+
+private:
+  std::atomic<bool> registered; ///< set once by registerSite
+  std::atomic<uint64_t> hits;
+  std::atomic<uint64_t> fails;
+  std::atomic<const std::string*> firstFailure; ///< set once, kept until the end of the process
+  const AssertionSite* next;                    ///< list of the reached sites
+
+  void registerSite();
+  void recordFirstFailure( const std::string& aValues );
+
+  static std::atomic<bool>& countingHits() {
+    static std::atomic<bool> sCounting( false );
+    return sCounting;
+  }
+};
+
+} // namespace ACatch
@@ -0,0 +1,75 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+//-----------------------------------------------------------------------------
+/// Record the report events of a test runner and replay them to another
+/// report in one go. Used by the parallel runner to keep the output of the
+/// test cases from interleaving.
+class ACATCH_API BufferedTestReport
+    : public ITestReport
+{
+public:
+  BufferedTestReport();
+  virtual ~BufferedTestReport();
+
+  virtual void setProperty( const std::string& aProp, const std::string& aValue ) override;
+
+  virtual void reportTestCases( const ConstTestCaseInfoRefs& aInfos ) override;
+  virtual void reportShard( uint aShardIndex, uint aShardCount, const ConstTestCaseInfoRefs& aInfos ) override;
+
+  virtual void reportTestCaseSkip( const TestCaseInfo& aInfo ) override;
+  virtual void reportTestCaseStart( const TestCaseInfo& aInfo ) override;
+  virtual void reportTestSectionStart( const SectionInfo& aInfo ) override;
+  virtual void reportTestSectionSkip( const SectionInfo& aInfo ) override;
+  virtual void reportTestSectionEnd( const SectionInfo& aInfo, TestCaseResult& aResult, const Timing& aTiming ) override;
+  virtual void reportTestCaseEnd( const TestCaseInfo& aInfo, TestCaseResult& aResult, const Timing& aTiming ) override;
+  /// Recorded like the other events: the logs reach the report on flushTo()
+  virtual void reportLogNow( TestCaseResult& aResult ) override;
+
+  virtual void reportTestRun( const ConstTestCaseInfoRefs& aInfos, TestRunResult& aRunResult ) override;
+  virtual void reportAssertionSites( const std::vector<const AssertionSite*>& aSites ) override;
+
+  /// Replay and clear the recorded events
+  void flushTo( ITestReport& aReport );
+
+  bool empty() const {
+    return mEvents.empty();
+  }
+
+protected:
+  enum class EEvent {
+    TestCaseSkip,
+    TestCaseStart,
+    TestSectionStart,
+    TestSectionSkip,
+    TestSectionEnd,
+    TestCaseEnd,
+    LogNow,
+  };
+
+  struct Event {
+    EEvent event;
+    const TestCaseInfo* testInfo;
+    std::unique_ptr<SectionInfo> sectionInfo;
+    std::unique_ptr<TestCaseResult> result;
+    Timing timing;
+
+    Event( EEvent aEvent )
+        : event( aEvent )
+        , testInfo( nullptr ) {
+    }
+  };
+
+  std::vector<Event> mEvents;
+
+  Event& addEvent( EEvent aEvent );
+};
+
+} // namespace ACatch
@@ -0,0 +1,33 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+namespace Detail {
+
+/// Containers up to this size are shown in full
+const size_t kDiffFullSize = 16;
+
+/// A change of a sequence: the lhsCount elements of lhs at lhsBegin are
+/// replaced by the rhsCount elements of rhs at rhsBegin
+struct DiffHunk {
+  size_t lhsBegin;
+  size_t lhsCount;
+  size_t rhsBegin;
+  size_t rhsCount;
+};
+
+/// Shortest edit script of two sequences (Myers), in at most aMaxEdits edits
+/// and aMaxSteps comparisons. When a budget is exceeded the part between the
+/// common prefix and suffix is returned as a single hunk and false.
+ACATCH_API bool diffSequences( size_t aLhsSize, size_t aRhsSize, bool ( *aEqual )( const void*, size_t, size_t ), const void* aContext,
+                               size_t aMaxEdits, size_t aMaxSteps, std::vector<DiffHunk>& aHunks );
+
+} // namespace Detail
+
+} // namespace ACatch
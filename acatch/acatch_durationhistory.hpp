@@ -0,0 +1,37 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+//-----------------------------------------------------------------------------
+/// Duration of the test cases measured by the previous runs. Used to schedule
+/// the longest test cases first. Thread-safe.
+class ACATCH_API DurationHistory
+{
+public:
+  DurationHistory() {
+  }
+
+  DurationHistory( const DurationHistory& ) = delete;
+  DurationHistory( const DurationHistory&& ) = delete;
+  DurationHistory& operator=( const DurationHistory& ) = delete;
+
+  /// Load the durations from a file, an unreadable file is an empty history
+  bool load( const std::string& aPath );
+  /// Save the durations, the entries loaded but not updated by this run are kept
+  bool save( const std::string& aPath ) const;
+
+  bool getDuration( const std::string& aName, double& aSeconds ) const;
+  void setDuration( const std::string& aName, double aSeconds );
+
+private:
+  mutable std::mutex mMutex;
+  std::map<std::string, double> mDurations;
+};
+
+} // namespace ACatch
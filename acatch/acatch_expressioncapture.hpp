@@ -23,6 +23,17 @@ enum class Operator {
   IsGreaterThanOrEqualTo
 };
 
+// the operands are compared as written in the assertion, a comparison of mixed
+// signedness belongs to the user's expression and is not reported in the library
+#if defined( __GNUC__ )
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wsign-compare"
+#elif defined( _MSC_VER )
+#  pragma warning( push )
+#  pragma warning( disable : 4389 ) // '==' : signed/unsigned mismatch
+#  pragma warning( disable : 4018 ) // '<' : signed/unsigned mismatch
+#endif
+
 template <Operator Op>
 struct OperatorTraits {
   static const char* getName() {
@@ -35,6 +46,11 @@ struct OperatorTraits<Operator::IsEqualTo> {
   static const char* getName() {
     return "==";
   }
+
+  template <typename L, typename R>
+  static bool evaluate( const L& aLhs, const R& aRhs ) {
+    return static_cast<bool>( aLhs == aRhs );
+  }
 };
 
 template <>
@@ -42,6 +58,11 @@ struct OperatorTraits<Operator::IsNotEqualTo> {
   static const char* getName() {
     return "!=";
   }
+
+  template <typename L, typename R>
+  static bool evaluate( const L& aLhs, const R& aRhs ) {
+    return static_cast<bool>( aLhs != aRhs );
+  }
 };
 
 template <>
@@ -49,6 +70,11 @@ struct OperatorTraits<Operator::IsLessThan> {
   static const char* getName() {
     return "<";
   }
+
+  template <typename L, typename R>
+  static bool evaluate( const L& aLhs, const R& aRhs ) {
+    return static_cast<bool>( aLhs < aRhs );
+  }
 };
 
 template <>
@@ -56,6 +82,11 @@ struct OperatorTraits<Operator::IsGreaterThan> {
   static const char* getName() {
     return ">";
   }
+
+  template <typename L, typename R>
+  static bool evaluate( const L& aLhs, const R& aRhs ) {
+    return static_cast<bool>( aLhs > aRhs );
+  }
 };
 
 template <>
@@ -63,6 +94,11 @@ struct OperatorTraits<Operator::IsLessThanOrEqualTo> {
   static const char* getName() {
     return "<=";
   }
+
+  template <typename L, typename R>
+  static bool evaluate( const L& aLhs, const R& aRhs ) {
+    return static_cast<bool>( aLhs <= aRhs );
+  }
 };
 
 template <>
@@ -70,8 +106,19 @@ struct OperatorTraits<Operator::IsGreaterThanOrEqualTo> {
   static const char* getName() {
     return ">=";
   }
+
+  template <typename L, typename R>
+  static bool evaluate( const L& aLhs, const R& aRhs ) {
+    return static_cast<bool>( aLhs >= aRhs );
+  }
 };
 
+#if defined( __GNUC__ )
+#  pragma GCC diagnostic pop
+#elif defined( _MSC_VER )
+#  pragma warning( pop )
+#endif
+
 /// Capture and expand an expression
 class ExpressionCapture {
 public:
@@ -79,9 +126,6 @@ public:
       : mRaw( aRaw ) {
   }
 
-  template <typename T>
-  ExpressionBuilder<T> operator<=( const T& aOperand );
-
   void add( const std::string& aOperand ) {
     mExpr.push_back( aOperand );
   }
@@ -91,18 +135,18 @@ public:
   }
 
   std::string getExpandedString() const {
-    std::ostringstream ss;
+    std::string expanded;
 
     bool first = true;
     for( const std::string& ec : mExpr ) {
       if( !first )
-        ss << " ";
+        expanded += " ";
 
       first = false;
-      ss << ec;
+      expanded += ec;
     }
 
-    return ss.str();
+    return expanded;
   }
 
 private:
@@ -133,13 +177,43 @@ public:
   };
   typedef std::vector<Expression> Expressions;
 
-  MultiExpressionCapture( EType aType )
-      : mType( aType ) {
+  MultiExpressionCapture( EType aType, bool aVerbose = false, AssertionSite* aSite = nullptr )
+      : mType( aType )
+      , mVerbose( aVerbose )
+      , mSite( aSite )
+      , mRepeated( -1 )
+      , mExpressions( nullptr ) {
   }
 
-  void add( const ExpressionCapture& aExpr ) {
-    mExpressions.emplace_back( aExpr.getRawString(),
-                               aExpr.getExpandedString() );
+  ~MultiExpressionCapture() {
+    if( mExpressions )
+      release();
+  }
+
+  MultiExpressionCapture( const MultiExpressionCapture& ) = delete;
+  MultiExpressionCapture& operator=( const MultiExpressionCapture& ) = delete;
+
+  ACATCH_INTERNAL_COLD void add( const ExpressionCapture& aExpr ) {
+    if( !mExpressions )
+      mExpressions = new Expressions();
+    mExpressions->emplace_back( aExpr.getRawString(),
+                                aExpr.getExpandedString() );
+  }
+
+  /// Evaluate a decomposed expression. The operands are evaluated once by the
+  /// caller, only the comparison is inlined: the conversion to string is out of
+  /// line and happens only if the expression is false or the capture is verbose.
+  /// The failures of a site already failed in the current result are only
+  /// counted, they are not expanded again.
+  template <typename TExpr>
+  bool evaluate( const char* aRaw, const TExpr& aExpr ) {
+    if( ACATCH_LIKELY( aExpr.evaluate() ) ) {
+      if( mVerbose )
+        capture( aRaw, aExpr );
+      return true;
+    }
+    captureFailure( aRaw, aExpr );
+    return false;
   }
 
   EType getType() const {
@@ -147,20 +221,60 @@ public:
   }
 
   const Expressions& getExpressions() const {
-    return mExpressions;
+    static const Expressions sEmpty;
+    return mExpressions ? *mExpressions : sEmpty;
+  }
+
+  AssertionSite* getSite() const {
+    return mSite;
+  }
+
+  /// The values of the expanded expressions
+  std::string getValues() const {
+    std::string values;
+    for( const Expression& expr : getExpressions() ) {
+      if( !values.empty() )
+        values += "; ";
+      values += expr.expanded;
+    }
+    return values;
   }
 
 private:
   EType mType;
-  Expressions mExpressions;
+  bool mVerbose;
+  AssertionSite* mSite;
+  int mRepeated;             ///< cached result of isRepeatedFailure, -1 before the first query
+  Expressions* mExpressions; ///< allocated by the first expansion
+
+  template <typename TExpr>
+  ACATCH_INTERNAL_COLD void capture( const char* aRaw, const TExpr& aExpr ) {
+    ExpressionCapture capture( aRaw );
+    aExpr.expand( capture );
+    add( capture );
+  }
+
+  template <typename TExpr>
+  ACATCH_INTERNAL_COLD void captureFailure( const char* aRaw, const TExpr& aExpr ) {
+    if( !isRepeated() )
+      capture( aRaw, aExpr );
+  }
+
+  ACATCH_INTERNAL_COLD void release() {
+    delete mExpressions;
+  }
+
+  bool isRepeated() {
+    if( mRepeated < 0 )
+      mRepeated = ( mSite && isRepeatedFailure( *mSite ) ) ? 1 : 0;
+    return mRepeated != 0;
+  }
 };
 
-#define ACATCH_EXPRBUILD_OP( OP )                                              \
+#define ACATCH_EXPRBUILD_OP( OP, OPERATOR )                                    \
   template <typename RhsT>                                                     \
-  ExpressionBuilder& operator OP( const RhsT& aRhs ) {                         \
-    mExpr.add( "\"" #OP "\"" );                                                \
-    mExpr.add( toString( aRhs ) );                                             \
-    return *this;                                                              \
+  BinaryExpression<T, Operator::OPERATOR, RhsT> operator OP( const RhsT& aRhs ) { \
+    return BinaryExpression<T, Operator::OPERATOR, RhsT>( mLhs, aRhs );        \
   }
 
 #define ACATCH_EXPRBUILD_OP_DISABLE( OP )                                      \
@@ -168,12 +282,290 @@ private:
   STATIC_ASSERT_Expression_Too_Complex_Please_Rewrite_As_Binary_Comparison     \
   operator OP( const RhsT& );
 
+namespace Detail {
+
+template <typename... T>
+struct VoidType {
+  typedef void type;
+};
+
+/// Containers with keys: map, set, their multi and unordered variants
+template <typename T, typename = void>
+struct IsAssociative : std::false_type {};
+
+template <typename T>
+struct IsAssociative<T, typename VoidType<typename T::key_type, typename T::value_type, decltype( std::declval<const T&>().find( std::declval<const typename T::key_type&>() ) )>::type>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct IsOrdered : std::false_type {};
+
+template <typename T>
+struct IsOrdered<T, typename VoidType<typename T::key_compare>::type> : std::true_type {};
+
+template <typename T, typename = void>
+struct IsMap : std::false_type {};
+
+template <typename T>
+struct IsMap<T, typename VoidType<typename T::mapped_type>::type> : std::true_type {};
+
+/// Containers with bidirectional iterators, addressable elements and a size:
+/// vector, deque, list, array
+template <typename T, typename = void>
+struct IsSequence : std::false_type {};
+
+template <typename T>
+struct IsSequence<T, typename VoidType<decltype( std::declval<const T&>().size() ), decltype( &*std::declval<const T&>().begin() ),
+                                       decltype( --std::declval<typename T::const_iterator&>() )>::type>
+    : std::integral_constant<bool, !IsAssociative<T>::value && !std::is_same<T, std::basic_string<typename T::value_type>>::value> {};
+
+/// Operands compared as strings: std::string and C strings
+template <typename T>
+struct IsStringOperand : std::false_type {};
+
+template <>
+struct IsStringOperand<std::string> : std::true_type {};
+
+template <>
+struct IsStringOperand<const char*> : std::true_type {};
+
+template <>
+struct IsStringOperand<char*> : std::true_type {};
+
+template <size_t N>
+struct IsStringOperand<char[ N ]> : std::true_type {};
+
+template <size_t N>
+struct IsStringOperand<const char[ N ]> : std::true_type {};
+
+/// A comparison of strings, two C strings are compared as pointers
+template <typename L, typename R>
+struct IsStringComparison
+    : std::integral_constant<bool, IsStringOperand<L>::value && IsStringOperand<R>::value &&
+                                       ( std::is_same<L, std::string>::value || std::is_same<R, std::string>::value )> {};
+
+inline bool toStringRef( const std::string& aString, StringRef& aRef ) {
+  aRef = StringRef( aString );
+  return true;
+}
+
+inline bool toStringRef( const char* aString, StringRef& aRef ) {
+  if( !aString )
+    return false;
+  aRef = StringRef( aString );
+  return true;
+}
+
+/// The entries of two compared containers for the diff computed in the library.
+/// Only these accessors are instantiated for each container type.
+struct ContainerDiffInput {
+  std::vector<const void*> lhs; ///< the entries in iteration order
+  std::vector<const void*> rhs;
+  const void* lhsContainer;
+  const void* rhsContainer;
+  std::string ( *format )( const void* aEntry );
+  bool ( *equal )( const void* aLhs, const void* aRhs ); ///< sequences: the elements are equal
+  const void* ( *find )( const void* aContainer, const void* aEntry );   ///< associative: the entry of the key of aEntry, nullptr if none
+  bool ( *less )( const void* aContainer, const void* aLhs, const void* aRhs ); ///< ordered: the key order, nullptr if unordered
+  bool ( *same )( const void* aLhs, const void* aRhs );  ///< associative: the entries of a same key hold the same value
+  std::string ( *formatChange )( const void* aLhs, const void* aRhs );
+};
+
+/// Add the sizes and the diff of two large containers to aCapture. False if
+/// both are small enough to be shown in full, nothing is added then.
+ACATCH_API bool addContainerDiff( ExpressionCapture& aCapture, const ContainerDiffInput& aInput, const char* aOperator );
+
+/// Add the sizes and the diff of two long strings to aCapture. False if both
+/// are short enough to be shown in full, nothing is added then.
+ACATCH_API bool addStringDiff( ExpressionCapture& aCapture, const StringRef& aLhs, const StringRef& aRhs, const char* aOperator );
+
+/// The elements of sequences and sets
+template <typename C, bool = IsMap<C>::value>
+struct ContainerEntry {
+  typedef typename C::value_type Value;
+
+  static const Value& get( const void* aEntry ) {
+    return *static_cast<const Value*>( aEntry );
+  }
+
+  static const Value& key( const void* aEntry ) {
+    return get( aEntry );
+  }
+
+  static std::string format( const void* aEntry ) {
+    return ::ACatch::toString( get( aEntry ) );
+  }
+
+  static bool equal( const void* aLhs, const void* aRhs ) {
+    return static_cast<bool>( get( aLhs ) == get( aRhs ) );
+  }
+
+  static bool same( const void*, const void* ) {
+    return true;
+  }
+
+  static std::string formatChange( const void* aLhs, const void* ) {
+    return format( aLhs );
+  }
+};
+
+/// The entries of maps, the entries of a same key are compared on their value
+template <typename C>
+struct ContainerEntry<C, true> {
+  typedef typename C::value_type Value;
+
+  static const Value& get( const void* aEntry ) {
+    return *static_cast<const Value*>( aEntry );
+  }
+
+  static const typename C::key_type& key( const void* aEntry ) {
+    return get( aEntry ).first;
+  }
+
+  static std::string format( const void* aEntry ) {
+    return ::ACatch::toString( get( aEntry ).first ) + ": " + ::ACatch::toString( get( aEntry ).second );
+  }
+
+  static bool equal( const void* aLhs, const void* aRhs ) {
+    return static_cast<bool>( get( aLhs ) == get( aRhs ) );
+  }
+
+  static bool same( const void* aLhs, const void* aRhs ) {
+    return static_cast<bool>( get( aLhs ).second == get( aRhs ).second );
+  }
+
+  static std::string formatChange( const void* aLhs, const void* aRhs ) {
+    return format( aLhs ) + " -> " + ::ACatch::toString( get( aRhs ).second );
+  }
+};
+
+template <typename C>
+const void* findContainerEntry( const void* aContainer, const void* aEntry ) {
+  const C& container = *static_cast<const C*>( aContainer );
+  auto found = container.find( ContainerEntry<C>::key( aEntry ) );
+  return found == container.end() ? nullptr : &*found;
+}
+
+template <typename C>
+bool lessContainerEntry( const void* aContainer, const void* aLhs, const void* aRhs ) {
+  return static_cast<const C*>( aContainer )->key_comp()( ContainerEntry<C>::key( aLhs ), ContainerEntry<C>::key( aRhs ) );
+}
+
+template <typename C>
+void setContainerOrder( ContainerDiffInput& aInput, std::true_type /*ordered*/ ) {
+  aInput.less = &lessContainerEntry<C>;
+}
+
+template <typename C>
+void setContainerOrder( ContainerDiffInput& aInput, std::false_type /*ordered*/ ) {
+  aInput.less = nullptr;
+}
+
+template <typename C>
+void setContainerLookup( ContainerDiffInput& aInput, std::true_type /*associative*/ ) {
+  aInput.find = &findContainerEntry<C>;
+  setContainerOrder<C>( aInput, IsOrdered<C>() );
+}
+
+template <typename C>
+void setContainerLookup( ContainerDiffInput& aInput, std::false_type /*associative*/ ) {
+  aInput.find = nullptr;
+  aInput.less = nullptr;
+}
+
+template <typename C>
+void fillContainerDiffInput( const C& aLhs, const C& aRhs, ContainerDiffInput& aInput ) {
+  typedef ContainerEntry<C> Entry;
+  for( const auto& entry : aLhs )
+    aInput.lhs.push_back( &entry );
+  for( const auto& entry : aRhs )
+    aInput.rhs.push_back( &entry );
+  aInput.lhsContainer = &aLhs;
+  aInput.rhsContainer = &aRhs;
+  aInput.format = &Entry::format;
+  aInput.equal = &Entry::equal;
+  aInput.same = &Entry::same;
+  aInput.formatChange = &Entry::formatChange;
+  setContainerLookup<C>( aInput, IsAssociative<C>() );
+}
+
+} // namespace Detail
+
+/// Comparison of two operands held by reference, valid until the end of the
+/// full expression
+template <typename L, Operator Op, typename R>
+class BinaryExpression {
+public:
+  BinaryExpression( const L& aLhs, const R& aRhs )
+      : mLhs( aLhs )
+      , mRhs( aRhs ) {
+  }
+
+  BinaryExpression& operator=( const BinaryExpression& ) = delete;
+
+  bool evaluate() const {
+    return OperatorTraits<Op>::evaluate( mLhs, mRhs );
+  }
+
+  void expand( ExpressionCapture& aCapture ) const {
+    expand( aCapture, Expansion() );
+  }
+
+  ACATCH_EXPRBUILD_OP_DISABLE( == )
+  ACATCH_EXPRBUILD_OP_DISABLE( != )
+  ACATCH_EXPRBUILD_OP_DISABLE( < )
+  ACATCH_EXPRBUILD_OP_DISABLE( > )
+  ACATCH_EXPRBUILD_OP_DISABLE( <= )
+  ACATCH_EXPRBUILD_OP_DISABLE( >= )
+  ACATCH_EXPRBUILD_OP_DISABLE( &&)
+  ACATCH_EXPRBUILD_OP_DISABLE( || )
+
+private:
+  const L& mLhs;
+  const R& mRhs;
+
+  enum EExpansion { Values, ContainerDiff, StringDiff };
+
+  /// Two large containers of the same type or two large strings compared for
+  /// equality are shown as a diff rather than in full
+  typedef std::integral_constant<
+      int, Op != Operator::IsEqualTo ? Values
+           : Detail::IsStringComparison<L, R>::value ? StringDiff
+           : std::is_same<L, R>::value && ( Detail::IsSequence<L>::value || Detail::IsAssociative<L>::value ) ? ContainerDiff
+                                                                                                          : Values>
+      Expansion;
+
+  void expand( ExpressionCapture& aCapture, std::integral_constant<int, Values> ) const {
+    aCapture.add( toString( mLhs ) );
+    aCapture.add( std::string( "\"" ) + OperatorTraits<Op>::getName() + "\"" );
+    aCapture.add( toString( mRhs ) );
+  }
+
+  /// The diffs are computed in the library, only the access to the entries is
+  /// instantiated here
+  void expand( ExpressionCapture& aCapture, std::integral_constant<int, ContainerDiff> ) const {
+    Detail::ContainerDiffInput input;
+    Detail::fillContainerDiffInput( mLhs, mRhs, input );
+    if( !Detail::addContainerDiff( aCapture, input, OperatorTraits<Op>::getName() ) )
+      expand( aCapture, std::integral_constant<int, Values>() );
+  }
+
+  void expand( ExpressionCapture& aCapture, std::integral_constant<int, StringDiff> ) const {
+    StringRef lhs;
+    StringRef rhs;
+    if( !Detail::toStringRef( mLhs, lhs ) || !Detail::toStringRef( mRhs, rhs ) ||
+        !Detail::addStringDiff( aCapture, lhs, rhs, OperatorTraits<Op>::getName() ) )
+      expand( aCapture, std::integral_constant<int, Values>() );
+  }
+};
+
+/// First operand of an expression held by reference. Evaluated as a boolean if
+/// no comparison follows.
 template <typename T>
 class ExpressionBuilder {
 public:
-  ExpressionBuilder( ExpressionCapture& aEC, const T& aOperand )
-      : mExpr( aEC ) {
-    mExpr.add( toString( aOperand ) );
+  explicit ExpressionBuilder( const T& aOperand )
+      : mLhs( aOperand ) {
   }
 
   ExpressionBuilder( const ExpressionBuilder& ) = default;
@@ -182,16 +574,20 @@ public:
   ExpressionBuilder& operator=( const ExpressionBuilder& ) = delete;
   ExpressionBuilder& operator=( ExpressionBuilder&& ) = delete;
 
-  ExpressionCapture& getCapture() {
-    return mExpr;
+  bool evaluate() const {
+    return mLhs ? true : false;
+  }
+
+  void expand( ExpressionCapture& aCapture ) const {
+    aCapture.add( toString( mLhs ) );
   }
 
-  ACATCH_EXPRBUILD_OP( == )
-  ACATCH_EXPRBUILD_OP( != )
-  ACATCH_EXPRBUILD_OP( < )
-  ACATCH_EXPRBUILD_OP( > )
-  ACATCH_EXPRBUILD_OP( <= )
-  ACATCH_EXPRBUILD_OP( >= )
+  ACATCH_EXPRBUILD_OP( ==, IsEqualTo )
+  ACATCH_EXPRBUILD_OP( !=, IsNotEqualTo )
+  ACATCH_EXPRBUILD_OP( <, IsLessThan )
+  ACATCH_EXPRBUILD_OP( >, IsGreaterThan )
+  ACATCH_EXPRBUILD_OP( <=, IsLessThanOrEqualTo )
+  ACATCH_EXPRBUILD_OP( >=, IsGreaterThanOrEqualTo )
   ACATCH_EXPRBUILD_OP_DISABLE( &&)
   ACATCH_EXPRBUILD_OP_DISABLE( || )
   ACATCH_EXPRBUILD_OP_DISABLE( & )
@@ -203,13 +599,16 @@ public:
   ACATCH_EXPRBUILD_OP_DISABLE( * )
 
 private:
-  ExpressionCapture& mExpr;
+  const T& mLhs;
 };
 
-template <typename T>
-inline ExpressionBuilder<T> ExpressionCapture::operator<=( const T& aOperand ) {
-  mExpr.clear();
-  return ExpressionBuilder<T>( *this, aOperand );
-}
+/// Split an expression into its operands: ExpressionDecomposer() <= a == b
+/// binds to ( ExpressionDecomposer() <= a ) == b
+struct ExpressionDecomposer {
+  template <typename T>
+  ExpressionBuilder<T> operator<=( const T& aOperand ) const {
+    return ExpressionBuilder<T>( aOperand );
+  }
+};
 
 } // namespace ACatch
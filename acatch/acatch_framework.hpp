@@ -26,16 +26,30 @@ public:
   void addFilter( const std::string& aPattern );
   bool matchFilter( const std::string& aName );
 
+  void setShard( uint aShardIndex, uint aShardCount );
+  void setDurationHistoryFile( const std::string& aPath );
+  void setDefaultTimeout( double aSeconds );
+  double getTimeout( const TestCaseInfo& aInfo ) const;
+
   void setBreak( EBreak aBreak );
+  void setJobs( uint aJobs );
+  void setIsolated( bool aIsolated );
+  void setForkSections( bool aForkSections );
+  void setRepeat( uint aRepeat );
+  void setLogRetention( uint aFirst, uint aLast );
+  void setMaxStringLength( uint aLength );
+  void setZygote( bool aZygote );
+  bool parseCommandLine( int aArgc, const char* const* aArgv );
 
   void registerTestCase( ITestCase* aTestCase );
-  void registerPreInit( FnPreInit aPreInit );
-  void runPreinits();
+  void registerPreInit( FnPreInit aPreInit, const PreInitInfo& aInfo = PreInitInfo() );
+  bool runPreinits();
   bool runAllTests();
   void reportAllTests();
 
   bool isAborting() const;
   bool isFailed() const;
+  bool isRepeatedFailure( const AssertionSite& aSite ) const;
   bool isRunning() const;
   bool isInAssertTest() const;
 
@@ -43,38 +57,71 @@ public:
   void handleSuccess();
   void handleSuccess( const std::string& aMessage );
   void handleSuccess( const MultiExpressionCapture& aExpr );
-  void handleFail( const std::string& aMessage );
-  void handleFail( const MultiExpressionCapture& aExpr );
-  void handleAbort( const std::string& aMessage );
-  void handleAbort( const MultiExpressionCapture& aExpr );
-  void handleFatalErrorCondition( const std::string& aMessage );
+  ACATCH_INTERNAL_COLD void handleFail( const std::string& aMessage );
+  ACATCH_INTERNAL_COLD void handleFail( const MultiExpressionCapture& aExpr );
+  ACATCH_INTERNAL_COLD void handleAbort( const std::string& aMessage );
+  ACATCH_INTERNAL_COLD void handleAbort( const MultiExpressionCapture& aExpr );
+  ACATCH_INTERNAL_COLD void handleFatalErrorCondition( const std::string& aMessage );
+  void handleTimeout( RunContext& aContext, const TestCaseInfo& aInfo, double aSeconds );
 
   void reportNow();
 
+  /// Run a test case in the given context, its report gets the events
+  void runTest( RunContext& aContext, ITestCase& aTestCase, TestRunResult& aRunResult );
+
   ITestReport* getTestReport() const {
     return mTestReport;
   }
 
+  /// The run context of the calling thread. A thread not bound to a context
+  /// gets the fallback context of the running test cases (see RunContextScope).
+  RunContext& context();
+  const RunContext& context() const;
+
 private:
   EBreak mBreakOnError;
+  uint mJobs;
+  bool mIsolated;
+  bool mForkSections;
+  uint mRepeat;
+  bool mZygote;
+  uint mShardIndex;
+  uint mShardCount;
+  std::string mDurationHistoryFile;
+  double mDefaultTimeout;
+  Watchdog mWatchdog;
   std::vector<std::string> mPatterns;
   TestRegistry mTestRegistry;
   ITestReport* mTestReport;
+  std::timed_mutex mReportMutex; ///< guard mTestReport while runners share the process
 
   bool mPreInitCompleted;
-  bool mInAssertTest;
-  TrackerContext* mTrackerContext;
-  ITracker* mTestCaseTracker;
-  TestCaseResult* mCurrentResult;
-  std::vector<SectionInfo> mUnfinishedSections;
-  std::vector<ITracker*> mActiveSections;
-
-  void runTest( ITestCase& aTestCase, TestRunResult& aRunResult );
-  void runTestGuarded( ITestCase& aTestCase );
-  void handleUnfinishedSections();
+  RunContext mMainContext;
+  std::atomic<RunContext*> mFallbackContext; ///< context of the unbound threads, mMainContext if nullptr
+
+  struct UnboundChecks;
+  UnboundChecks* mUnboundChecks; ///< collect the checks of the unbound threads while runners share the process
+
+  std::vector<ITestCase*> getShardTests();
+  void recordDuration( const TestCaseInfo& aInfo, double aSeconds );
+  void runTests( const std::vector<ITestCase*>& aTests, TestRunResult& aRunResult );
+  void runTestsParallel( const std::vector<ITestCase*>& aTests, TestRunResult& aRunResult );
+  bool runTestCycles( RunContext& aContext, ITestCase& aTestCase, TrackerContext& aTrackerContext,
+                      TestRunResult& aRunResult, bool aSingleCycle );
+  void runSectionsParallel( RunContext& aContext, ITestCase& aTestCase, TrackerContext& aTrackerContext,
+                            TestRunResult& aRunResult );
+  void runTestGuarded( RunContext& aContext, ITestCase& aTestCase );
+  void beginUnboundChecks( UnboundChecks& aChecks );
+  void endUnboundChecks( UnboundChecks& aChecks, ITestReport& aReport, TestRunResult& aRunResult );
+  static const TestCaseInfo& unboundChecksInfo();
+  void reportOutsideTestCase( const char* aEvent, const std::string& aMessage );
+  bool lockReportForExit( std::unique_lock<std::timed_mutex>& aLock );
+  void logFailure( TestCaseResult& aResult, const MultiExpressionCapture& aExpr );
+  void logCaptures( TestCaseResult& aResult );
+  void handleUnfinishedSections( RunContext& aContext );
   bool sectionStarted( const SectionInfo& aSectionInfo );
-  void sectionEnded( const SectionInfo& aSectionInfo );
-  void sectionEndedEarly( const SectionInfo& aSectionInfo );
+  void sectionEnded( const SectionInfo& aSectionInfo, const Timing& aTiming );
+  void sectionEndedEarly( const SectionInfo& aSectionInfo, const Timing& aTiming );
 
 private:
   static Framework* sInstance;
@@ -83,6 +130,8 @@ private:
   friend void theACatchShutdown();
   friend class Section;
   friend class TestAssertGuard;
+  friend class IsolatedRunner;
+  friend class Zygote;
 };
 
 } // namespace ACatch
@@ -0,0 +1,114 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+//-----------------------------------------------------------------------------
+/// Run the test cases on a pool of forked worker processes. The workers pull
+/// the test cases from the parent and stream the report events back on a pipe.
+/// A crashing test case takes down only its worker: the test is reported as
+/// aborted and the worker is replaced, as is a worker exceeding the time
+/// budget of its test case.
+/// The events are forwarded to the given report, the one of the framework by
+/// default. On platforms without fork the test cases are run in-process.
+class ACATCH_API IsolatedRunner
+{
+public:
+  IsolatedRunner( Framework& aFramework, uint aWorkerCount, ITestReport* aTestReport = nullptr );
+  ~IsolatedRunner();
+
+  IsolatedRunner( const IsolatedRunner& ) = delete;
+  IsolatedRunner( const IsolatedRunner&& ) = delete;
+  IsolatedRunner& operator=( const IsolatedRunner& ) = delete;
+
+  void run( const std::vector<ITestCase*>& aTests, TestRunResult& aRunResult );
+
+private:
+  struct Worker;
+
+  Framework& mFramework;
+  ITestReport* mTestReport;
+  uint mWorkerCount;
+  const std::vector<ITestCase*>* mTests;
+  size_t mNextTest;
+  std::vector<std::unique_ptr<Worker>> mWorkers;
+
+  bool spawnWorker( Worker& aWorker );
+  void workerMain( int aInput, int aOutput );
+  void assignNextTest( Worker& aWorker );
+  void processMessages( Worker& aWorker, TestRunResult& aRunResult );
+  void handleWorkerExit( Worker& aWorker, TestRunResult& aRunResult );
+  int killOverdueWorkers();
+  void recordDuration( Worker& aWorker );
+};
+
+//-----------------------------------------------------------------------------
+/// Run the test cases in a process forked from the calling one, used once the
+/// preinits are done so each run starts from the warmed state and shares its
+/// pages copy-on-write. The child streams its report events back like the
+/// workers of the IsolatedRunner, then its results, durations and assertion
+/// site counts. The events are forwarded to the given report, the one of the
+/// framework by default. On platforms without fork the tests are run in-process.
+class ACATCH_API Zygote
+{
+public:
+  Zygote( Framework& aFramework, ITestReport* aTestReport = nullptr );
+
+  void run( const std::vector<ITestCase*>& aTests, TestRunResult& aRunResult );
+
+private:
+  Framework& mFramework;
+  ITestReport* mTestReport;
+};
+
+//-----------------------------------------------------------------------------
+/// Execute the sections of a test case in forked processes. At the first entry
+/// of a section the process forks: the child executes the section from the
+/// copy-on-write state of the parent and streams its report events back, the
+/// parent skips the section and goes on with the next ones. The code before the
+/// sections is executed once instead of once for each leaf section. The code
+/// after a section is executed by the child and again by the process that
+/// forked it, on the state without the side effects of the section: its checks
+/// are counted each time, unlike the serial cycles where it runs once per leaf.
+class ACATCH_API SectionForker
+{
+public:
+  SectionForker( double aTimeoutSeconds );
+  ~SectionForker();
+
+  SectionForker( const SectionForker& ) = delete;
+  SectionForker( const SectionForker&& ) = delete;
+  SectionForker& operator=( const SectionForker& ) = delete;
+
+  static bool isSupported();
+
+  /// Fork a process for the section being entered. Return true if the calling
+  /// process shall execute the section: in the child, or if the fork failed.
+  /// Return false in the parent once the child has ended, its events are
+  /// forwarded to the report and its results merged into the current result.
+  bool fork( RunContext& aContext );
+
+  bool isForked() const {
+    return mOutput >= 0;
+  }
+
+  /// End a forked process at the end of its test cycle
+  void exitForked();
+
+  /// Kill the running child, if any
+  void killChild();
+
+private:
+  std::chrono::steady_clock::time_point mDeadline;
+  bool mHasDeadline;
+  int mOutput;                           ///< pipe to the parent in a forked process, -1 otherwise
+  std::unique_ptr<ITestReport> mReport;  ///< report to the parent in a forked process
+  std::atomic<int> mChild;               ///< pid of the running child, 0 if none
+};
+
+} // namespace ACatch
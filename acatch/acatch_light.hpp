@@ -0,0 +1,410 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#pragma once
+
+/// The assertion and registration macros with only the part of the framework
+/// they expand to: the framework itself is forward declared, the common
+/// comparisons are instantiated in the library and the diffs of the failed
+/// comparisons are computed there. A test file including this header instead
+/// of acatch.hpp compiles faster, acatch.hpp adds the test runner, the
+/// registry, the reports and ACATCH_SECTION_ASSERT_BEGIN / END.
+
+// configuration defines:
+//#define ACATCH_API                   ... api linkage
+//#define ACATCH_INTERNAL_ASSERT(...)  ... assert used for the internal erros of the test framework
+//#define ACATCH_SELFTEST              ... enable self test
+//#define ACATCH_SELFTEST_MUSTFAIL     ... enable self test those are successfull on failure
+//#define ACATCH_BREAK                 ... the os dependent break-on-debugger command (nop by default)
+//#define ACATCH_NO_EXTERN_TEMPLATES   ... instantiate the common comparisons in each test file instead of the library
+
+#include "acatch_config.hpp"
+
+#if !defined( ACATCH_API ) || !defined( ACATCH_INTERNAL_ASSERT ) || !defined( ACATCH_BREAK )
+#  error "Some required define was not provided"
+#endif
+
+/// Keep the failure handling out of the inlined assertion code
+#if defined( __GNUC__ )
+#  define ACATCH_INTERNAL_COLD __attribute__( ( cold, noinline ) )
+#  define ACATCH_LIKELY( x ) __builtin_expect( !!( x ), 1 )
+#elif defined( _MSC_VER )
+#  define ACATCH_INTERNAL_COLD __declspec( noinline )
+#  define ACATCH_LIKELY( x ) ( x )
+#else
+#  define ACATCH_INTERNAL_COLD
+#  define ACATCH_LIKELY( x ) ( x )
+#endif
+
+/// The decomposition of "a == b" as "Decomposer() <= a == b" is intended
+#if defined( __GNUC__ )
+#  define ACATCH_INTERNAL_SUPPRESS_PARENTHESES_WARNINGS                      \
+    _Pragma( "GCC diagnostic push" )                                         \
+    _Pragma( "GCC diagnostic ignored \"-Wparentheses\"" )
+#  define ACATCH_INTERNAL_RESTORE_WARNINGS _Pragma( "GCC diagnostic pop" )
+#else
+#  define ACATCH_INTERNAL_SUPPRESS_PARENTHESES_WARNINGS
+#  define ACATCH_INTERNAL_RESTORE_WARNINGS
+#endif
+
+#include <atomic>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace ACatch {
+
+class ACATCH_API Framework;
+struct ACATCH_API AssertionSite;
+extern ACATCH_API Framework& theACatch();
+extern ACATCH_API void theACatchShutdown();
+extern ACATCH_API bool isFailed();
+extern ACATCH_API bool isAborting();
+extern ACATCH_API void fatal( const std::string& aMessage );
+extern ACATCH_API bool isRepeatedFailure( const AssertionSite& aSite );
+
+/// Entry points of the assertion and log macros, forwarded to theACatch()
+class MultiExpressionCapture;
+extern ACATCH_API void handleLog( const std::string& aMessage );
+extern ACATCH_API void handleSuccess();
+extern ACATCH_API void handleSuccess( const MultiExpressionCapture& aExpr );
+extern ACATCH_API ACATCH_INTERNAL_COLD void handleFail( const std::string& aMessage );
+extern ACATCH_API ACATCH_INTERNAL_COLD void handleFail( const MultiExpressionCapture& aExpr );
+extern ACATCH_API ACATCH_INTERNAL_COLD void handleAbort( const std::string& aMessage );
+extern ACATCH_API ACATCH_INTERNAL_COLD void handleAbort( const MultiExpressionCapture& aExpr );
+
+enum EBreak {
+  Break_Never,
+  Break_Critical,
+  Break_Abort,
+  Break_Fail,
+};
+
+inline bool constexpr alwaysTrue() {
+  return true;
+}
+
+
+inline bool constexpr alwaysFalse() {
+  return false;
+}
+
+
+struct TestFailureException {};
+
+/// During test for assertion this exception is thrown
+struct TestAssert
+{
+  TestAssert() {
+  }
+
+  TestAssert( const std::string& aMsg )
+      : msg( aMsg ) {
+  }
+
+  std::string msg;
+};
+
+typedef unsigned int uint;
+
+} // namespace ACatch
+
+#include "acatch/acatch_string.hpp"
+#include "acatch/acatch_timer.hpp"
+#include "acatch/acatch_tostring.hpp"
+#include "acatch/acatch_scopedcapture.hpp"
+#include "acatch/acatch_assertionsite.hpp"
+#include "acatch/acatch_expressioncapture.hpp"
+#include "acatch/acatch_rangecompare.hpp"
+#include "acatch/acatch_approx.hpp"
+#include "acatch/acatch_testcase.hpp"
+#include "acatch/acatch_section.hpp"
+
+namespace ACatch {
+
+/// Instantiations of the expansion of the comparisons of the same or of
+/// close built in types
+#define ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, L, OP, R )                \
+  PREFIX void MultiExpressionCapture::capture( const char*, const BinaryExpression<L, Operator::OP, R>& ); \
+  PREFIX void MultiExpressionCapture::captureFailure( const char*, const BinaryExpression<L, Operator::OP, R>& );
+
+#define ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, L, R )                   \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, L, IsEqualTo, R )               \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, L, IsNotEqualTo, R )            \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, L, IsLessThan, R )              \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, L, IsGreaterThan, R )           \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, L, IsLessThanOrEqualTo, R )     \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, L, IsGreaterThanOrEqualTo, R )
+
+#define ACATCH_INTERNAL_EXPRESSION_INSTANCES( PREFIX )                         \
+  ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, int, int )                     \
+  ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, unsigned int, unsigned int )   \
+  ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, long, long )                   \
+  ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, unsigned long, unsigned long ) \
+  ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, unsigned long, int )           \
+  ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, long long, long long )         \
+  ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, unsigned long long, unsigned long long ) \
+  ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, unsigned long, unsigned int ) \
+  ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, long, int )                    \
+  ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, double, double )               \
+  ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, double, int )                  \
+  ACATCH_INTERNAL_COMPARISON_INSTANCES( PREFIX, char, char )                   \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, bool, IsEqualTo, bool )         \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, bool, IsNotEqualTo, bool )      \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, std::string, IsEqualTo, std::string ) \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, std::string, IsNotEqualTo, std::string ) \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, std::string, IsEqualTo, const char* ) \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, std::vector<int>, IsEqualTo, std::vector<int> ) \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, std::vector<double>, IsEqualTo, std::vector<double> ) \
+  ACATCH_INTERNAL_EXPRESSION_INSTANCE( PREFIX, std::vector<std::string>, IsEqualTo, std::vector<std::string> ) \
+  PREFIX void MultiExpressionCapture::capture( const char*, const ExpressionBuilder<bool>& ); \
+  PREFIX void MultiExpressionCapture::captureFailure( const char*, const ExpressionBuilder<bool>& ); \
+  PREFIX std::string toString( const long& );                                 \
+  PREFIX std::string toString( const long long& );                            \
+  PREFIX std::string toString( const unsigned long long& );                   \
+  PREFIX std::string toString( const std::vector<int>& );                     \
+  PREFIX std::string toString( const std::vector<double>& );                  \
+  PREFIX std::string toString( const std::vector<std::string>& );
+
+#ifndef ACATCH_NO_EXTERN_TEMPLATES
+ACATCH_INTERNAL_EXPRESSION_INSTANCES( extern template )
+#endif
+
+} // namespace ACatch
+
+#define ACATCH_DO_JOIN( X, Y ) ACATCH_DO2_JOIN( X, Y )
+#define ACATCH_DO2_JOIN( X, Y ) X ## Y
+
+#define ACATCH_JOIN2( X, Y ) ACATCH_DO_JOIN( X, Y )
+#define ACATCH_JOIN3( X, Y, Z ) ACATCH_JOIN2( ACATCH_JOIN2( X, Y ), Z )
+#define ACATCH_JOIN4( X, Y, Z, W ) ACATCH_JOIN2( ACATCH_JOIN2( ACATCH_JOIN2( X, Y ), Z ), W )
+#define ACATCH_JOIN5( X, Y, Z, W, Q ) ACATCH_JOIN2( ACATCH_JOIN2( ACATCH_JOIN2( ACATCH_JOIN2( X, Y ), Z ), W ), Q )
+
+#define ACATCH_UNIQUE_NAME_LINE2( name, line ) name ## line
+#define ACATCH_UNIQUE_NAME_LINE( name, line ) ACATCH_UNIQUE_NAME_LINE2( name, line )
+#define ACATCH_UNIQUE_NAME( name ) ACATCH_UNIQUE_NAME_LINE( name, __LINE__ )
+
+// call a macro for_each argument
+#define ACATCH_EXPAND( x ) x
+#define ACATCH_VA_FOR_EACH_1( WHAT, x, ... ) WHAT( x )
+#define ACATCH_VA_FOR_EACH_2( WHAT, x, ... ) WHAT( x ) ACATCH_EXPAND( ACATCH_VA_FOR_EACH_1( WHAT, __VA_ARGS__ ) )
+#define ACATCH_VA_FOR_EACH_3( WHAT, x, ... ) WHAT( x ) ACATCH_EXPAND( ACATCH_VA_FOR_EACH_2( WHAT, __VA_ARGS__ ) )
+#define ACATCH_VA_FOR_EACH_4( WHAT, x, ... ) WHAT( x ) ACATCH_EXPAND( ACATCH_VA_FOR_EACH_3( WHAT, __VA_ARGS__ ) )
+#define ACATCH_VA_FOR_EACH_5( WHAT, x, ... ) WHAT( x ) ACATCH_EXPAND( ACATCH_VA_FOR_EACH_4( WHAT, __VA_ARGS__ ) )
+#define ACATCH_VA_FOR_EACH_6( WHAT, x, ... ) WHAT( x ) ACATCH_EXPAND( ACATCH_VA_FOR_EACH_5( WHAT, __VA_ARGS__ ) )
+#define ACATCH_VA_FOR_EACH_7( WHAT, x, ... ) WHAT( x ) ACATCH_EXPAND( ACATCH_VA_FOR_EACH_6( WHAT, __VA_ARGS__ ) )
+#define ACATCH_VA_FOR_EACH_8( WHAT, x, ... ) WHAT( x ) ACATCH_EXPAND( ACATCH_VA_FOR_EACH_7( WHAT, __VA_ARGS__ ) )
+#define ACATCH_VA_FOR_EACH_NARG( ... ) ACATCH_VA_FOR_EACH_NARG_( __VA_ARGS__, ACATCH_VA_FOR_EACH_RSEQ_N() )
+#define ACATCH_VA_FOR_EACH_NARG_( ... ) ACATCH_EXPAND( ACATCH_VA_FOR_EACH_ARG_N( __VA_ARGS__ ) )
+#define ACATCH_VA_FOR_EACH_ARG_N( _1, _2, _3, _4, _5, _6, _7, _8, NAME, ... ) NAME
+#define ACATCH_VA_FOR_EACH_RSEQ_N() 8, 7, 6, 5, 4, 3, 2, 1, 0
+#define ACATCH_VA_FOR_EACH_CONCATENATE( x, y ) x ## y
+#define ACATCH_VA_FOR_EACH_( NAME, WHAT, ... ) \
+  ACATCH_EXPAND( ACATCH_VA_FOR_EACH_CONCATENATE( ACATCH_VA_FOR_EACH_, NAME )( WHAT, __VA_ARGS__ ) )
+#define ACATCH_VA_FOR_EACH( WHAT, ... ) \
+  ACATCH_VA_FOR_EACH_( ACATCH_VA_FOR_EACH_NARG( __VA_ARGS__ ), WHAT, __VA_ARGS__ )
+
+/// Each expression is evaluated once, the operands are converted to string only
+/// when the expression is false or the capture is verbose. As with || and &&
+/// the evaluation stops once the result is known.
+#define ACATCH_EVAL_Any( expr )                                                \
+  ACATCH_INTERNAL_SUPPRESS_PARENTHESES_WARNINGS                                \
+  if( !acatch_internal_exprRes )                                               \
+    acatch_internal_exprRes = acatch_internal_exprStr.evaluate(                \
+      #expr, ::ACatch::ExpressionDecomposer() <= expr );                       \
+  ACATCH_INTERNAL_RESTORE_WARNINGS
+#define ACATCH_EVAL_All( expr )                                                \
+  ACATCH_INTERNAL_SUPPRESS_PARENTHESES_WARNINGS                                \
+  if( acatch_internal_exprRes )                                                \
+    acatch_internal_exprRes = acatch_internal_exprStr.evaluate(                \
+      #expr, ::ACatch::ExpressionDecomposer() <= expr );                       \
+  ACATCH_INTERNAL_RESTORE_WARNINGS
+
+/// The static descriptor of the assertion, counts the evaluations and the failures
+#define ACATCH_ASSERTION_SITE( KIND, ... )                                     \
+  static ::ACatch::AssertionSite acatch_internal_site{                         \
+    __FILE__, __LINE__, KIND, #__VA_ARGS__ };                                  \
+  ACATCH_INTERNAL_SITE_ENTRY( acatch_internal_site )                           \
+  acatch_internal_site.hit();
+
+#define ACATCH_MULTI_REQUIRE_EVAL( CONCAT, DEFVALUE, VERBOSE, SITE, ... )      \
+  bool acatch_internal_exprRes = DEFVALUE;                                     \
+  ::ACatch::MultiExpressionCapture acatch_internal_exprStr(                    \
+    ::ACatch::MultiExpressionCapture::CONCAT, VERBOSE, SITE );                 \
+  ACATCH_VA_FOR_EACH( ACATCH_JOIN2( ACATCH_EVAL_, CONCAT ), __VA_ARGS__ )
+
+#define ACATCH_MULTI_REQUIRE_INTERNAL( CONCAT, DEFVALUE, ... )                 \
+  do {                                                                         \
+    ACATCH_MULTI_REQUIRE_EVAL( CONCAT, DEFVALUE, false, nullptr, __VA_ARGS__ ); \
+    ACATCH_INTERNAL_ASSERT( acatch_internal_exprRes );                         \
+  } while( ::ACatch::alwaysFalse() )
+
+#define ACATCH_MULTI_REQUIRE_EXPECT_VERBOSE( CONCAT, DEFVALUE, ... )           \
+  do {                                                                         \
+    ACATCH_ASSERTION_SITE( "EXPECT_VERBOSE", __VA_ARGS__ )                     \
+    ACATCH_MULTI_REQUIRE_EVAL( CONCAT, DEFVALUE, true, &acatch_internal_site,  \
+                               __VA_ARGS__ );                                  \
+    if( ACATCH_LIKELY( acatch_internal_exprRes ) ) {                           \
+      ::ACatch::handleSuccess( acatch_internal_exprStr );          \
+    } else {                                                                   \
+      ::ACatch::handleFail( acatch_internal_exprStr );             \
+    }                                                                          \
+  } while( ::ACatch::alwaysFalse() )
+
+#define ACATCH_MULTI_REQUIRE_EXPECT( CONCAT, DEFVALUE, ... )                   \
+  do {                                                                         \
+    ACATCH_ASSERTION_SITE( "EXPECT", __VA_ARGS__ )                             \
+    ACATCH_MULTI_REQUIRE_EVAL( CONCAT, DEFVALUE, false, &acatch_internal_site, \
+                               __VA_ARGS__ );                                  \
+    if( ACATCH_LIKELY( acatch_internal_exprRes ) ) {                           \
+      ::ACatch::handleSuccess();                                   \
+    } else {                                                                   \
+      ::ACatch::handleFail( acatch_internal_exprStr );             \
+    }                                                                          \
+  } while( ::ACatch::alwaysFalse() )
+
+#define ACATCH_MULTI_REQUIRE_EXPECT_FAST( CONCAT, DEFVALUE, ... )              \
+  do {                                                                         \
+    ACATCH_ASSERTION_SITE( "EXPECT_FAST", __VA_ARGS__ )                        \
+    ACATCH_MULTI_REQUIRE_EVAL( CONCAT, DEFVALUE, false, &acatch_internal_site, \
+                               __VA_ARGS__ );                                  \
+    if( !ACATCH_LIKELY( acatch_internal_exprRes ) ) {                          \
+      ::ACatch::handleFail( acatch_internal_exprStr );             \
+    }                                                                          \
+  } while( ::ACatch::alwaysFalse() )
+
+#define ACATCH_MULTI_REQUIRE_ASSERT_VERBOSE( CONCAT, DEFVALUE, ... )           \
+  do {                                                                         \
+    ACATCH_ASSERTION_SITE( "ASSERT_VERBOSE", __VA_ARGS__ )                     \
+    ACATCH_MULTI_REQUIRE_EVAL( CONCAT, DEFVALUE, true, &acatch_internal_site,  \
+                               __VA_ARGS__ );                                  \
+    if( ACATCH_LIKELY( acatch_internal_exprRes ) ) {                           \
+      ::ACatch::handleSuccess( acatch_internal_exprStr );          \
+    } else {                                                                   \
+      ::ACatch::handleAbort( acatch_internal_exprStr );            \
+    }                                                                          \
+  } while( ::ACatch::alwaysFalse() )
+
+#define ACATCH_MULTI_REQUIRE_ASSERT( CONCAT, DEFVALUE, ... )                   \
+  do {                                                                         \
+    ACATCH_ASSERTION_SITE( "ASSERT", __VA_ARGS__ )                             \
+    ACATCH_MULTI_REQUIRE_EVAL( CONCAT, DEFVALUE, false, &acatch_internal_site, \
+                               __VA_ARGS__ );                                  \
+    if( ACATCH_LIKELY( acatch_internal_exprRes ) ) {                           \
+      ::ACatch::handleSuccess();                                   \
+    } else {                                                                   \
+      ::ACatch::handleAbort( acatch_internal_exprStr );            \
+    }                                                                          \
+  } while( ::ACatch::alwaysFalse() )
+
+#define ACATCH_MULTI_REQUIRE_ASSERT_FAST( CONCAT, DEFVALUE, ... )              \
+  do {                                                                         \
+    ACATCH_ASSERTION_SITE( "ASSERT_FAST", __VA_ARGS__ )                        \
+    ACATCH_MULTI_REQUIRE_EVAL( CONCAT, DEFVALUE, false, &acatch_internal_site, \
+                               __VA_ARGS__ );                                  \
+    if( !ACATCH_LIKELY( acatch_internal_exprRes ) ) {                          \
+      ::ACatch::handleAbort( acatch_internal_exprStr );            \
+    }                                                                          \
+  } while( ::ACatch::alwaysFalse() )
+
+// test framework API macros
+
+/// The preinit macro takes optionally the name and the dependencies of the preinit (PreInitInfo)
+#define ACATCH_PREINIT( ... )                                               \
+  static void ACATCH_UNIQUE_NAME( acatch_preinit )( );                      \
+  namespace {                                                               \
+  ::ACatch::AutoReg ACATCH_UNIQUE_NAME( acatch_internal_Autoregister )(     \
+    ACATCH_UNIQUE_NAME( acatch_preinit ),                                   \
+    ::ACatch::PreInitInfo( __VA_ARGS__ ) );                                 \
+  }                                                                         \
+  static void ACATCH_UNIQUE_NAME( acatch_preinit )( )
+
+/// The test case macros take the name and optionally the TestCaseInfo::EFlags, the timeout in seconds
+/// and the names of the required preinits
+#define ACATCH_TEST_CASE( ... )                                                          \
+  static void ACATCH_UNIQUE_NAME( acatch_internal_TestCase )( );                         \
+  namespace {                                                                            \
+  ::ACatch::AutoReg ACATCH_UNIQUE_NAME( acatch_internal_Autoregister )(                  \
+    ::ACatch::AutoReg::mkFunctionTest( &ACATCH_UNIQUE_NAME( acatch_internal_TestCase )   \
+                                       , ::ACatch::TestCaseInfo( __VA_ARGS__ ) ) );      \
+  }                                                                                      \
+  static void ACATCH_UNIQUE_NAME( acatch_internal_TestCase )( )
+#define ACATCH_DISABLE_TEST_CASE( ... )                                        \
+  static void ACATCH_UNIQUE_NAME( acatch_internal_TestCase )( )
+
+#define ACATCH_TEST_CASE_FIXTURE( QUALIFIEDMETHOD, ... )                       \
+  namespace {                                                                  \
+  ::ACatch::AutoReg ACATCH_UNIQUE_NAME( acatch_internal_TestCase )(            \
+    ::ACatch::AutoReg::mkFixtureTest( QUALIFIEDMETHOD                          \
+                                      , ::ACatch::TestCaseInfo( __VA_ARGS__ ) ) ); \
+  }
+#define ACATCH_DISABLE_TEST_CASE_FIXTURE( ... )
+
+#define ACATCH_TEST_CASE_METHOD( QUALIFIEDMETHOD, ... )                       \
+  namespace {                                                                 \
+  ::ACatch::AutoReg ACATCH_UNIQUE_NAME( acatch_internal_TestCase )(         \
+    ::ACatch::AutoReg::mkMethodTest( QUALIFIEDMETHOD                        \
+                                     , ::ACatch::TestCaseInfo( __VA_ARGS__ ) ) ); \
+  }
+#define ACATCH_DISABLE_TEST_CASE_METHOD( ... )
+
+/// Define a a section block within a test-case.
+#define ACATCH_SECTION( name )                                                 \
+  if( const ACatch::Section & ACATCH_UNIQUE_NAME( acatch_internal_Section ) =  \
+        ::ACatch::SectionInfo( name ) )                                        \
+    if( ACATCH_UNIQUE_NAME( acatch_internal_Section ) )
+
+/// Disable a a section block within a test-case.
+#define ACATCH_DISABLE_SECTION( ... )  \
+  if( ::ACatch::alwaysFalse() )
+
+/// Capture an expression until the end of the enclosing scope. The value is
+/// referenced, not copied, and logged only if an assertion of the same thread
+/// fails in the scope. A temporary is kept alive by the capture.
+#define ACATCH_CAPTURE( expr )                                                 \
+  const auto& ACATCH_UNIQUE_NAME( acatch_internal_Captured ) = ( expr );       \
+  ::ACatch::ScopedCapture ACATCH_UNIQUE_NAME( acatch_internal_ExprCapture )(   \
+    #expr, ACATCH_UNIQUE_NAME( acatch_internal_Captured ) )
+
+/// The testing macros
+/// TYPE:
+/// * EXPECT            on failure: log expression, continue test case; on success: increment counter
+/// * EXPECT_VERBOSE    on failure: log expression, continue test case; on success: log expression
+/// * EXPECT_FAST       on failure: log expression, continue test case; on success: do nothing
+/// * ASSERT            on failure: log expression, abort test case; on success: increment counter
+/// * ASSERT_VERBOSE    on failure: log expression, abort test case; on success: log expression
+/// * ASSERT_FAST       on failure: log expression, abort test case; on success: do nothing
+/// * INTERNAL          used to signal internal (test framework) errors
+#define ACATCH_REQUIRE( TYPE, expr )    ACATCH_JOIN2( ACATCH_MULTI_REQUIRE_, TYPE )( Any, false, expr )
+#define ACATCH_REQUIRE_ANY( TYPE, ... ) ACATCH_JOIN2( ACATCH_MULTI_REQUIRE_, TYPE )( Any, false, __VA_ARGS__ )
+#define ACATCH_REQUIRE_ALL( TYPE, ... ) ACATCH_JOIN2( ACATCH_MULTI_REQUIRE_, TYPE )( All, true, __VA_ARGS__ )
+
+/// Compare two contiguous ranges (containers with data() and size(), arrays)
+/// element by element as a single assertion. On failure the first mismatches
+/// are reported with the elements around them.
+#define ACATCH_REQUIRE_RANGE_EQ( TYPE, lhs, rhs ) \
+  ACATCH_JOIN2( ACATCH_MULTI_REQUIRE_, TYPE )( Any, false, ::ACatch::rangeEq( lhs, rhs ) )
+#define ACATCH_REQUIRE_RANGE_NEAR( TYPE, lhs, rhs, tolerance ) \
+  ACATCH_JOIN2( ACATCH_MULTI_REQUIRE_, TYPE )( Any, false, ::ACatch::rangeNear( lhs, rhs, tolerance ) )
+/// Compare two float or double ranges with a Tolerance, the report gives the
+/// number of elements out of tolerance, the first one and the worst error
+#define ACATCH_REQUIRE_RANGE_APPROX( TYPE, lhs, rhs, tolerance ) \
+  ACATCH_JOIN2( ACATCH_MULTI_REQUIRE_, TYPE )( Any, false, ::ACatch::rangeApprox( lhs, rhs, tolerance ) )
+
+/// Log user messages and states
+#define ACATCH_FAIL( msg )  ::ACatch::handleFail( msg )
+#define ACATCH_ABORT( msg ) ::ACatch::handleAbort( msg )
+#define ACATCH_WARN( msg )  ::ACatch::handleLog( msg )
+#define ACATCH_INFO( msg )  ::ACatch::handleLog( msg )
@@ -0,0 +1,56 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+//-----------------------------------------------------------------------------
+/// Bump allocator of the log messages. Allocation is thread-safe and lock-free
+/// until the current block is exhausted. The memory is released all at once by
+/// reset, the blocks are kept and reused by the next allocations.
+class ACATCH_API LogArena
+{
+public:
+  LogArena();
+  ~LogArena();
+
+  LogArena( const LogArena& ) = delete;
+  LogArena& operator=( const LogArena& ) = delete;
+
+  /// Allocate aSize bytes aligned for any fundamental type
+  void* allocate( size_t aSize );
+
+  /// Copy a string into the arena, the result is valid until the next reset
+  StringRef copy( const StringRef& aString );
+
+  /// Release all the allocations in O(1). No allocation may run concurrently and
+  /// the references to the allocated memory must not be used anymore.
+  void reset();
+
+  /// Number of blocks allocated from the heap
+  size_t getBlockCount() const;
+
+private:
+  struct alignas( std::max_align_t ) Block {
+    std::atomic<size_t> used;
+    size_t capacity;
+    Block* next;
+
+    char* data() {
+      return reinterpret_cast<char*>( this + 1 );
+    }
+  };
+
+  std::atomic<Block*> mCurrent; ///< block served by allocate, nullptr until the first allocation
+  Block* mFirst;                ///< the chain of the blocks, guarded by mMutex
+  size_t mBlockCount;
+  mutable std::mutex mMutex;    ///< guard the switch to the next block
+
+  Block* nextBlock( Block* aExhausted, size_t aSize );
+};
+
+} // namespace ACatch
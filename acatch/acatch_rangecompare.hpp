@@ -0,0 +1,222 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+namespace Detail {
+
+template <typename C>
+auto rangeData( const C& aRange ) -> decltype( aRange.data() ) {
+  return aRange.data();
+}
+
+template <typename T, size_t N>
+const T* rangeData( const T ( &aRange )[ N ] ) {
+  return aRange;
+}
+
+template <typename C>
+size_t rangeSize( const C& aRange ) {
+  return aRange.size();
+}
+
+template <typename T, size_t N>
+size_t rangeSize( const T ( & )[ N ] ) {
+  return N;
+}
+
+template <typename C>
+struct RangeElement {
+  typedef typename std::remove_cv<typename std::remove_pointer<decltype( rangeData( std::declval<const C&>() ) )>::type>::type type;
+};
+
+/// The elements compare equal when their bytes are equal
+template <typename T>
+struct IsBitwiseComparable {
+  enum { value = std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value };
+};
+
+template <typename T>
+struct EqualPredicate {
+  bool operator()( const T& aLhs, const T& aRhs ) const {
+    return aLhs == aRhs;
+  }
+};
+
+/// |lhs - rhs| <= tolerance, false for NaN. The floating point form has no
+/// branch, so the blocks of float and double are vectorized.
+template <typename T, bool IsFloat = std::is_floating_point<T>::value>
+struct NearPredicate {
+  T tolerance;
+
+  bool operator()( const T& aLhs, const T& aRhs ) const {
+    return ( aLhs < aRhs ? aRhs - aLhs : aLhs - aRhs ) <= tolerance;
+  }
+};
+
+template <typename T>
+struct NearPredicate<T, true> {
+  T tolerance;
+
+  bool operator()( const T& aLhs, const T& aRhs ) const {
+    return ( aLhs - aRhs <= tolerance ) & ( aRhs - aLhs <= tolerance );
+  }
+};
+
+const size_t kRangeBlock = 64;
+
+/// Index of the first element in [aBegin, aEnd) for which aPred is false, aEnd
+/// if none. The blocks are reduced without branches, so the compiler can
+/// vectorize them, only the block holding the mismatch is scanned.
+template <typename T, typename TPred>
+size_t findMismatch( const T* aLhs, const T* aRhs, size_t aBegin, size_t aEnd, const TPred& aPred, std::false_type ) {
+  size_t i = aBegin;
+  for( ; i + kRangeBlock <= aEnd; i += kRangeBlock ) {
+    unsigned bad = 0;
+    for( size_t j = 0; j < kRangeBlock; ++j )
+      bad |= aPred( aLhs[ i + j ], aRhs[ i + j ] ) ? 0u : 1u;
+    if( bad )
+      break;
+  }
+  for( ; i < aEnd; ++i ) {
+    if( !aPred( aLhs[ i ], aRhs[ i ] ) )
+      return i;
+  }
+  return aEnd;
+}
+
+/// Same for bitwise comparable elements compared for equality, the blocks are
+/// compared with memcmp
+template <typename T, typename TPred>
+size_t findMismatch( const T* aLhs, const T* aRhs, size_t aBegin, size_t aEnd, const TPred& aPred, std::true_type ) {
+  const size_t kBlock = 4096 / sizeof( T ) + 1;
+  size_t i = aBegin;
+  for( ; i + kBlock <= aEnd; i += kBlock ) {
+    if( std::memcmp( aLhs + i, aRhs + i, kBlock * sizeof( T ) ) != 0 )
+      break;
+  }
+  for( ; i < aEnd; ++i ) {
+    if( !aPred( aLhs[ i ], aRhs[ i ] ) )
+      return i;
+  }
+  return aEnd;
+}
+
+template <typename T>
+std::string rangeElementToString( const void* aData, size_t aIndex ) {
+  return ::ACatch::toString( static_cast<const T*>( aData )[ aIndex ] );
+}
+
+/// Render the first mismatches of a range comparison with the elements around
+/// each of them, aFormat converts an element of a range to string
+ACATCH_API std::string rangeMismatchesToString( const void* aLhs, size_t aLhsSize, const void* aRhs, size_t aRhsSize,
+                                                const size_t* aMismatches, size_t aShown, uint64_t aCount,
+                                                const std::string& aTolerance,
+                                                std::string ( *aFormat )( const void*, size_t ) );
+
+} // namespace Detail
+
+//-----------------------------------------------------------------------------
+/// Result of the comparison of two contiguous ranges, element by element. The
+/// whole ranges are compared at construction, the first mismatches are kept
+/// and converted to string only when the comparison is expanded.
+template <typename T>
+class RangeComparison
+{
+public:
+  enum { kShown = 5 }; ///< number of mismatches reported
+
+  template <typename TPred>
+  RangeComparison( const T* aLhs, size_t aLhsSize, const T* aRhs, size_t aRhsSize, const TPred& aPred )
+      : mLhs( aLhs )
+      , mRhs( aRhs )
+      , mLhsSize( aLhsSize )
+      , mRhsSize( aRhsSize )
+      , mShown( 0 )
+      , mCount( 0 ) {
+    typedef std::integral_constant<bool, Detail::IsBitwiseComparable<T>::value && !std::is_same<TPred, Detail::NearPredicate<T>>::value> Bitwise;
+    size_t size = aLhsSize < aRhsSize ? aLhsSize : aRhsSize;
+    for( size_t i = Detail::findMismatch( aLhs, aRhs, 0, size, aPred, Bitwise() ); i < size;
+         i = Detail::findMismatch( aLhs, aRhs, i + 1, size, aPred, Bitwise() ) ) {
+      if( mShown < kShown )
+        mMismatches[ mShown++ ] = i;
+      ++mCount;
+    }
+  }
+
+  explicit operator bool() const {
+    return mCount == 0 && mLhsSize == mRhsSize;
+  }
+
+  uint64_t getMismatchCount() const {
+    return mCount;
+  }
+
+  std::string toString( const std::string& aTolerance ) const {
+    return Detail::rangeMismatchesToString( mLhs, mLhsSize, mRhs, mRhsSize, mMismatches, mShown, mCount,
+                                            aTolerance, &Detail::rangeElementToString<T> );
+  }
+
+private:
+  const T* mLhs;
+  const T* mRhs;
+  size_t mLhsSize;
+  size_t mRhsSize;
+  size_t mMismatches[ kShown ]; ///< indexes of the first mismatches
+  size_t mShown;
+  uint64_t mCount;              ///< number of mismatches in the common part
+};
+
+/// Comparison with tolerance, keep the tolerance for the report
+template <typename T>
+class RangeNearComparison : public RangeComparison<T>
+{
+public:
+  RangeNearComparison( const T* aLhs, size_t aLhsSize, const T* aRhs, size_t aRhsSize, T aTolerance )
+      : RangeComparison<T>( aLhs, aLhsSize, aRhs, aRhsSize, Detail::NearPredicate<T>{ aTolerance } )
+      , mTolerance( aTolerance ) {
+  }
+
+  T getTolerance() const {
+    return mTolerance;
+  }
+
+private:
+  T mTolerance;
+};
+
+template <typename T>
+std::string toString( const RangeComparison<T>& aComparison ) {
+  return aComparison.toString( std::string() );
+}
+
+template <typename T>
+std::string toString( const RangeNearComparison<T>& aComparison ) {
+  return aComparison.toString( ::ACatch::toString( aComparison.getTolerance() ) );
+}
+
+/// Compare two contiguous ranges (containers with data() and size(), arrays)
+/// of the same element type with ==
+template <typename L, typename R>
+RangeComparison<typename Detail::RangeElement<L>::type> rangeEq( const L& aLhs, const R& aRhs ) {
+  typedef typename Detail::RangeElement<L>::type T;
+  static_assert( std::is_same<T, typename Detail::RangeElement<R>::type>::value, "the ranges must have the same element type" );
+  return RangeComparison<T>( Detail::rangeData( aLhs ), Detail::rangeSize( aLhs ), Detail::rangeData( aRhs ), Detail::rangeSize( aRhs ),
+                             Detail::EqualPredicate<T>() );
+}
+
+/// Compare two contiguous ranges of the same element type with |lhs - rhs| <= aTolerance
+template <typename L, typename R>
+RangeNearComparison<typename Detail::RangeElement<L>::type> rangeNear( const L& aLhs, const R& aRhs, typename Detail::RangeElement<L>::type aTolerance ) {
+  typedef typename Detail::RangeElement<L>::type T;
+  static_assert( std::is_same<T, typename Detail::RangeElement<R>::type>::value, "the ranges must have the same element type" );
+  return RangeNearComparison<T>( Detail::rangeData( aLhs ), Detail::rangeSize( aLhs ), Detail::rangeData( aRhs ), Detail::rangeSize( aRhs ),
+                                 aTolerance );
+}
+
+} // namespace ACatch
@@ -0,0 +1,134 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+class SectionForker;
+
+//-----------------------------------------------------------------------------
+/// Execution state of a test runner (tracker, current result, section stacks).
+/// Each worker owns a context and the ACATCH_* macros are routed to the
+/// context bound to the calling thread.
+class ACATCH_API RunContext
+{
+public:
+  RunContext( ITestReport* aTestReport, bool aGuardSignals = true )
+      : mTestReport( aTestReport )
+      , mGuardSignals( aGuardSignals )
+      , mForked( false )
+      , mInAssertTest( false )
+      , mTrackerContext( nullptr )
+      , mTestCaseTracker( nullptr )
+      , mCurrentResult( nullptr )
+      , mSectionPathTracker( nullptr ) {
+  }
+
+  RunContext( const RunContext& ) = delete;
+  RunContext( const RunContext&& ) = delete;
+  RunContext& operator=( const RunContext& ) = delete;
+
+  ITestReport* getTestReport() const {
+    return mTestReport;
+  }
+
+  /// True if the sections of the running test case are executed in forked processes
+  bool isForkingSections() const {
+    return mSectionForker != nullptr;
+  }
+
+  /// The context bound to the calling thread, nullptr if none
+  static RunContext* current();
+  static void setCurrent( RunContext* aContext );
+
+private:
+  ITestReport* mTestReport;
+  bool mGuardSignals;   ///< install the signal handlers for the test cases, false if the owner of the thread does it
+  bool mForked;         ///< runs in a process forked by a runner, the parent reports the end of the process
+  std::vector<std::string> mSectionPath; ///< when set, only the sections on this path (test case and section names) are executed
+  bool mInAssertTest;
+  TrackerContext* mTrackerContext;
+  ITracker* mTestCaseTracker;
+  TestCaseResult* mCurrentResult;
+  std::vector<std::pair<SectionInfo, Timing>> mUnfinishedSections;
+  std::vector<ITracker*> mActiveSections;
+  std::vector<std::string> mForkedSections; ///< sections running in the forked child, innermost last
+  std::vector<RunContext*> mSectionContexts; ///< contexts of the parallel sections of the running test case
+  std::mutex mWatchMutex; ///< guards mCurrentResult, mActiveSections, mForkedSections and mSectionContexts against the watchdog thread
+  ITracker* mSectionPathTracker; ///< tracker of the section selected by mSectionPath once entered
+  std::unique_ptr<SectionForker> mSectionForker; ///< set when the sections of the test case are forked
+  LogArena mLogArena; ///< storage of the logs of the current test cycle
+
+  friend class Framework;
+  friend class TestAssertGuard;
+  friend class IsolatedRunner;
+  friend class Zygote;
+  friend class SectionForker;
+};
+
+
+/// Bind a context to the current thread for the lifetime of the guard.
+/// A thread started by a test case and not bound to a context falls back to
+/// the context of the running test case when the test cases run one at a time
+/// in the process. Under --jobs the test case that started it cannot be known:
+/// its checks are reported as a test case of their own at the end of the run.
+/// Bind such threads to the context of their test case, with inheritContext or:
+///   ACatch::RunContext* ctx = ACatch::RunContext::current();
+///   std::thread t( [ctx] { ACatch::RunContextScope scope( ctx ); ... } );
+class ACATCH_API RunContextScope
+{
+public:
+  RunContextScope( RunContext* aContext )
+      : mPrevious( RunContext::current() ) {
+    RunContext::setCurrent( aContext );
+  }
+
+  ~RunContextScope() {
+    RunContext::setCurrent( mPrevious );
+  }
+
+  RunContextScope( const RunContextScope& ) = delete;
+  RunContextScope( const RunContextScope&& ) = delete;
+  RunContextScope& operator=( const RunContextScope& ) = delete;
+
+private:
+  RunContext* mPrevious;
+};
+
+
+/// A function bound to a run context, see inheritContext
+template <typename TFunction>
+class ContextBoundFunction
+{
+public:
+  ContextBoundFunction( RunContext* aContext, TFunction aFunction )
+      : mContext( aContext )
+      , mFunction( std::move( aFunction ) ) {
+  }
+
+  template <typename... TArgs>
+  void operator()( TArgs&&... aArgs ) {
+    RunContextScope scope( mContext );
+    mFunction( std::forward<TArgs>( aArgs )... );
+  }
+
+private:
+  RunContext* mContext;
+  TFunction mFunction;
+};
+
+
+/// Bind a function to the context of the calling thread, to run it on another
+/// thread with the checks attributed to the calling test case:
+///   std::thread t( ACatch::inheritContext( [] { ACATCH_REQUIRE( EXPECT, ... ); } ) );
+template <typename TFunction>
+ContextBoundFunction<typename std::decay<TFunction>::type> inheritContext( TFunction&& aFunction ) {
+  return ContextBoundFunction<typename std::decay<TFunction>::type>( RunContext::current(),
+                                                                    std::forward<TFunction>( aFunction ) );
+}
+
+} // namespace ACatch
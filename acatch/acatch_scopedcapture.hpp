@@ -0,0 +1,64 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+//-----------------------------------------------------------------------------
+/// Capture of a value for the lifetime of the enclosing scope, used by
+/// ACATCH_CAPTURE. Only the address of the value and its expression are pushed
+/// on a fixed-size stack of the calling thread, the value is converted to
+/// string when an assertion of the thread fails in the scope.
+class ACATCH_API ScopedCapture
+{
+public:
+  template <typename T>
+  ScopedCapture( const char* aExpression, const T& aValue ) {
+    Stack& stack = getStack();
+    if( stack.depth < kCapacity )
+      stack.entries[ stack.depth ] = Entry{ aExpression, &aValue, &format<T> };
+    ++stack.depth;
+  }
+
+  ~ScopedCapture() {
+    --getStack().depth;
+  }
+
+  ScopedCapture( const ScopedCapture& ) = delete;
+  ScopedCapture& operator=( const ScopedCapture& ) = delete;
+
+  /// The captures of the calling thread formatted as "expression" = value,
+  /// the outermost first
+  static std::vector<std::string> formatActive();
+
+private:
+  static const size_t kCapacity = 32; ///< the deeper captures are only counted
+
+  struct Entry {
+    const char* expression;
+    const void* value;
+    std::string ( *format )( const void* aValue );
+  };
+
+  struct Stack {
+    Entry entries[ kCapacity ];
+    size_t depth;
+  };
+
+  /// Zero initialized, no guard is needed for the thread local
+  static Stack& getStack() {
+    static thread_local Stack sStack;
+    return sStack;
+  }
+
+  template <typename T>
+  static std::string format( const void* aValue ) {
+    return toString( *static_cast<const T*>( aValue ) );
+  }
+};
+
+} // namespace ACatch
@@ -36,6 +36,7 @@ public:
 private:
   SectionInfo mInfo;
   bool mSectionIncluded;
+  Timer mTimer;
 };
 
 } // namespace ACatch
@@ -19,16 +19,18 @@ public:
   virtual void setProperty( const std::string& aProp, const std::string& aValue ) override;
 
   virtual void reportTestCases( const ConstTestCaseInfoRefs& aInfos ) override;
+  virtual void reportShard( uint aShardIndex, uint aShardCount, const ConstTestCaseInfoRefs& aInfos ) override;
 
   virtual void reportTestCaseSkip( const TestCaseInfo& aInfo ) override;
   virtual void reportTestCaseStart( const TestCaseInfo& aInfo ) override;
   virtual void reportTestSectionStart( const SectionInfo& aInfo ) override;
   virtual void reportTestSectionSkip( const SectionInfo& aInfo ) override;
-  virtual void reportTestSectionEnd( const SectionInfo& aInfo, TestCaseResult& aResult ) override;
-  virtual void reportTestCaseEnd( const TestCaseInfo& aInfo, TestCaseResult& aResult ) override;
+  virtual void reportTestSectionEnd( const SectionInfo& aInfo, TestCaseResult& aResult, const Timing& aTiming ) override;
+  virtual void reportTestCaseEnd( const TestCaseInfo& aInfo, TestCaseResult& aResult, const Timing& aTiming ) override;
   virtual void reportLogNow( TestCaseResult& aResult ) override;
 
   virtual void reportTestRun( const ConstTestCaseInfoRefs& aInfos, TestRunResult& aRunResult ) override;
+  virtual void reportAssertionSites( const std::vector<const AssertionSite*>& aSites ) override;
 
 
 protected:
@@ -42,12 +44,19 @@ protected:
     List,
   };
 
+  typedef std::map<std::string, Timing> Timings;
+
   std::vector<std::string> mNames;
   bool mVerbose;
   size_t mDepth;
+  size_t mSlowestCount;   ///< number of the slowest test cases and sections to report
+  bool mAllSites;         ///< report every assertion site, not only the failed ones
+  Timings mTestTimings;   ///< total time of the test cases (all cycles)
+  Timings mSectionTimings;///< total time of the sections by full name
 
   void printTestResult( TestCaseResult& aResult, bool aCompleted );
   void printTestName( State aState );
+  void printSlowest( const char* aTitle, const Timings& aTimings );
 };
 
 } // namespace ACatch
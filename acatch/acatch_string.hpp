@@ -8,6 +8,62 @@
 
 namespace ACatch {
 
+/// Non-owning reference to a character range, the owner keeps it alive
+class StringRef {
+public:
+  StringRef()
+      : mData( "" )
+      , mSize( 0 ) {
+  }
+
+  StringRef( const char* aData, size_t aSize )
+      : mData( aData )
+      , mSize( aSize ) {
+  }
+
+  StringRef( const char* aString )
+      : mData( aString )
+      , mSize( std::strlen( aString ) ) {
+  }
+
+  StringRef( const std::string& aString )
+      : mData( aString.data() )
+      , mSize( aString.size() ) {
+  }
+
+  const char* data() const {
+    return mData;
+  }
+
+  size_t size() const {
+    return mSize;
+  }
+
+  bool empty() const {
+    return mSize == 0;
+  }
+
+  std::string str() const {
+    return std::string( mData, mSize );
+  }
+
+  bool operator==( const StringRef& aOther ) const {
+    return mSize == aOther.mSize && std::memcmp( mData, aOther.mData, mSize ) == 0;
+  }
+
+  bool operator!=( const StringRef& aOther ) const {
+    return !( *this == aOther );
+  }
+
+private:
+  const char* mData;
+  size_t mSize;
+};
+
+inline std::ostream& operator<<( std::ostream& aStream, const StringRef& aRef ) {
+  return aStream.write( aRef.data(), static_cast<std::streamsize>( aRef.size() ) );
+}
+
 struct CaseSensitive {
   enum Choice { Yes, No };
 };
@@ -33,7 +89,8 @@ inline bool contains( const std::string& s, const std::string& infix ) {
 }
 
 inline void toLowerInPlace( std::string& s ) {
-  std::transform( s.begin(), s.end(), s.begin(), ::tolower );
+  for( char& c : s )
+    c = static_cast<char>( ::tolower( c ) );
 }
 
 inline std::string toLower( const std::string& s ) {
@@ -50,19 +107,26 @@ inline std::string trim( const std::string& str ) {
   return start != std::string::npos ? str.substr( start, 1 + end - start ) : "";
 }
 
+/// Replace all the occurrences of replaceThis, in a single pass. An empty
+/// replaceThis replaces nothing.
 inline bool replaceInPlace( std::string& str, const std::string& replaceThis,
                             const std::string& withThis ) {
-  bool replaced = false;
+  if( replaceThis.empty() )
+    return false;
   std::size_t i = str.find( replaceThis );
-  while( i != std::string::npos ) {
-    replaced = true;
-    str = str.substr( 0, i ) + withThis + str.substr( i + replaceThis.size() );
-    if( i < str.size() - withThis.size() )
-      i = str.find( replaceThis, i + withThis.size() );
-    else
-      i = std::string::npos;
+  if( i == std::string::npos )
+    return false;
+  std::string replaced;
+  replaced.reserve( str.size() );
+  std::size_t begin = 0;
+  for( ; i != std::string::npos; i = str.find( replaceThis, begin ) ) {
+    replaced.append( str, begin, i - begin );
+    replaced += withThis;
+    begin = i + replaceThis.size();
   }
-  return replaced;
+  replaced.append( str, begin, std::string::npos );
+  str.swap( replaced );
+  return true;
 }
 
 } // namespace ACatch
@@ -0,0 +1,27 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+namespace Detail {
+
+/// Strings up to this size without line break are shown in full
+const size_t kStringDiffFullSize = 64;
+
+/// The line diff of two strings with the changes of the lines replaced one by
+/// one highlighted between > <, empty if both strings are shown in full. The
+/// line and character diffs have a budget, past it the part between the
+/// common prefix and suffix is shown as a single change.
+ACATCH_API std::string diffStrings( const StringRef& aLhs, const StringRef& aRhs );
+
+/// "{ 1024 bytes, 12 lines }"
+ACATCH_API std::string stringSummary( const StringRef& aString );
+
+} // namespace Detail
+
+} // namespace ACatch
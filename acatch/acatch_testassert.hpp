@@ -13,11 +13,11 @@ namespace ACatch {
 class ACATCH_API TestAssertGuard {
 public:
   TestAssertGuard() {
-    theACatch().mInAssertTest = true;
+    theACatch().context().mInAssertTest = true;
   }
 
   ~TestAssertGuard() {
-    theACatch().mInAssertTest = false;
+    theACatch().context().mInAssertTest = false;
   }
 };
 
@@ -0,0 +1,215 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+//-----------------------------------------------------------------------------
+/// Test section information.
+struct ACATCH_API TestCaseInfo
+{
+  enum EFlags {
+    None = 0,
+    ParallelSections = 1 << 0, ///< run the top level sections concurrently (not for fixtures)
+    ForkSections = 1 << 1,     ///< execute each section in a process forked at its entry (see SectionForker)
+  };
+
+  TestCaseInfo( const char* aName, uint aFlags = None, double aTimeoutSeconds = 0, const char* aPreInits = "" )
+      : name( aName )
+      , flags( aFlags )
+      , timeoutSeconds( aTimeoutSeconds )
+      , preinits( aPreInits ) {
+  }
+
+  bool hasFlag( EFlags aFlag ) const {
+    return ( flags & aFlag ) != 0;
+  }
+
+  std::string name;
+  uint flags;
+  double timeoutSeconds; ///< time budget of the test case, 0 to use the default of the run
+  std::string preinits;  ///< names of the required preinits, separated by commas or spaces
+};
+
+typedef std::vector<const TestCaseInfo*> ConstTestCaseInfoRefs;
+
+//-----------------------------------------------------------------------------
+/// Interface for the test cases
+class ACATCH_API ITestCase
+{
+public:
+  ITestCase( const TestCaseInfo& aInfo )
+      : mInfo( aInfo ) {
+  }
+
+  virtual ~ITestCase() {
+  }
+
+  const TestCaseInfo& testInfo() const {
+    return mInfo;
+  }
+
+  virtual void setUp() = 0;
+  virtual void tearDown() = 0;
+  virtual void invoke() = 0;
+
+  /// Indicates if invoke may be called concurrently from multiple threads
+  virtual bool isReentrant() const {
+    return true;
+  }
+
+protected:
+  TestCaseInfo mInfo;
+};
+
+typedef void(*FnPreInit)();
+
+//-----------------------------------------------------------------------------
+/// Preinit information. A named preinit is executed only when a selected test
+/// case requires it, directly or through another preinit. The unnamed ones are
+/// always executed, in their registration order and on the calling thread of
+/// runPreinits, before the named ones they do not depend on.
+struct ACATCH_API PreInitInfo
+{
+  PreInitInfo( const char* aName = "", const char* aDependencies = "" )
+      : name( aName )
+      , dependencies( aDependencies ) {
+  }
+
+  std::string name;
+  std::string dependencies; ///< names of the preinits to execute before, separated by commas or spaces
+};
+
+/// Test a class through the given function.
+/// During each invocation a new instance of the class is created.
+template <typename TClass>
+class MethodTestCase
+    : public ITestCase
+{
+public:
+  MethodTestCase( void( TClass::*aMethod )(), const TestCaseInfo& aInfo )
+      : ITestCase( aInfo )
+      , mMethod( aMethod ) {
+  }
+
+  virtual void setUp() {
+  }
+
+  virtual void invoke() {
+    TClass obj;
+    ( obj.*mMethod )();
+  }
+
+  virtual void tearDown() {
+  }
+
+private:
+  void ( TClass::*mMethod )();
+};
+
+
+/// Fixture based test case.
+/// Only a single object is created, and the method is called for each test section.
+template <typename TClass>
+class FixtureTestCase
+    : public ITestCase
+{
+public:
+  FixtureTestCase( void( TClass::*aMethod )(), const TestCaseInfo &aInfo )
+      : ITestCase( aInfo )
+      , mMethod( aMethod )
+      , mObj( nullptr ) {
+  }
+
+  virtual void setUp() {
+    mObj = new TClass;
+  }
+
+  virtual void invoke() {
+    ( mObj->*mMethod )();
+  }
+
+  virtual bool isReentrant() const {
+    return false;
+  }
+
+  virtual void tearDown() {
+    delete mObj;
+  }
+
+private:
+  TClass* mObj;
+  void (TClass::*mMethod)();
+};
+
+
+/// Function based test case.
+class ACATCH_API FunctionTestCase
+    : public ITestCase
+{
+public:
+  typedef void ( *Function )();
+
+  FunctionTestCase( Function aFun, const TestCaseInfo& aInfo )
+      : ITestCase( aInfo )
+      , mFunction( aFun ) {
+  }
+
+  virtual void setUp() {
+  }
+
+  virtual void invoke() {
+    mFunction();
+  }
+
+  virtual void tearDown() {
+  }
+
+private:
+  Function mFunction;
+};
+
+//-----------------------------------------------------------------------------
+/// Helper to register test cases.
+struct ACATCH_API AutoReg
+{
+  template <AutoReg&>
+  struct ForceReference {};
+
+  static ITestCase* mkFunctionTest( FunctionTestCase::Function aFunction, const TestCaseInfo& aInfo ) {
+    return new FunctionTestCase( aFunction, aInfo );
+  }
+
+  template <typename TClass>
+  static ITestCase* mkFixtureTest( void ( TClass::*aMethod )(), const TestCaseInfo& aInfo ) {
+    return new FixtureTestCase<TClass>( aMethod, aInfo );
+  }
+
+  template <typename TClass>
+  static ITestCase* mkMethodTest( void ( TClass::*aMethod )(), const TestCaseInfo& aInfo ) {
+    return new MethodTestCase<TClass>( aMethod, aInfo );
+  }
+
+  AutoReg( ITestCase* aTestCase ) {
+    if( aTestCase )
+      registerTestCase( aTestCase );
+  }
+
+  AutoReg( FnPreInit aPreInit, const PreInitInfo& aInfo ) {
+    registerPreInit( aPreInit, aInfo );
+  }
+
+  AutoReg( const AutoReg& ) = delete;
+  AutoReg( const AutoReg&& ) = delete;
+  AutoReg& operator=( const AutoReg& ) = delete;
+
+private:
+  void registerTestCase( ITestCase* aTestCase );
+  void registerPreInit( FnPreInit aPreInit, const PreInitInfo& aInfo );
+};
+
+} // namespace ACatch
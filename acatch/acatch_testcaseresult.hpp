@@ -10,7 +10,20 @@ namespace ACatch {
 
 //-----------------------------------------------------------------------------
 /// Store the result of the current test case. Thread-safe multiple thread may
-/// log/check the result at the same time.
+/// log/check the result at the same time. Each thread counts its successes and
+/// keeps its logs in a producer of its own, padded so that threads asserting
+/// concurrently do not share a cache line; the counters are summed when the
+/// result is read. Logging is lock-free and
+/// preserves the order of the messages of each thread: each thread fills a batch
+/// of its own and publishes it with an atomic exchange, the drain of the
+/// reporter takes the published batches the same way.
+/// The retention is bounded: between two drains a thread keeps its first
+/// messages and a ring of its last ones, the messages in between are counted
+/// and reported as dropped. Consecutive identical messages are collapsed into a
+/// single "repeated" message.
+/// The messages are stored in a LogArena, the one of the run context for the
+/// results of the test cycles, otherwise an arena owned by the result. The
+/// taken logs reference the arena and are valid until it is reset.
 struct TestCaseResult
 {
 public:
@@ -24,15 +37,34 @@ public:
     Error_ExprExpanded,
 
   };
-  typedef std::pair<ELog, std::string> Log;
+  typedef std::pair<ELog, StringRef> Log;
   typedef std::vector<Log> Logs;
 
-  TestCaseResult()
+  explicit TestCaseResult( LogArena* aArena = nullptr )
       : mHasNew( false )
       , mFails( 0 )
-      , mSuccess( 0 ) {
+      , mArena( aArena ? aArena : &mOwnArena )
+      , mRetentionFirst( getDefaultRetentionFirst() )
+      , mRetentionLast( getDefaultRetentionLast() )
+      , mSuccessBase( 0 )
+      , mId( nextId() )
+      , mProducers( nullptr ) {
   }
 
+  ~TestCaseResult() {
+    Producer* producer = mProducers.load( std::memory_order_acquire );
+    while( producer ) {
+      Producer* next = producer->next;
+      delete producer->batch.load( std::memory_order_relaxed );
+      delete producer->spare.load( std::memory_order_relaxed );
+      delete producer;
+      producer = next;
+    }
+  }
+
+  TestCaseResult( const TestCaseResult& ) = delete;
+  TestCaseResult& operator=( const TestCaseResult& ) = delete;
+
   void logFail() {
     mHasNew.store( true, std::memory_order_relaxed );
     mFails.fetch_add( 2, std::memory_order_relaxed );
@@ -44,8 +76,10 @@ public:
   }
 
   void logSuccess() {
-    mHasNew.store( true, std::memory_order_relaxed );
-    mSuccess.fetch_add( 1, std::memory_order_relaxed );
+    Producer& producer = currentProducer();
+    producer.success.fetch_add( 1, std::memory_order_relaxed );
+    if( !producer.hasNew.load( std::memory_order_relaxed ) )
+      producer.hasNew.store( true, std::memory_order_relaxed );
   }
 
   bool isFailed() const {
@@ -56,33 +90,346 @@ public:
     return mFails.load( std::memory_order_relaxed ) & 0x1;
   }
 
-  int getFailCount() const {
+  uint64_t getFailCount() const {
     return mFails.load( std::memory_order_relaxed ) / 2;
   }
 
-  int getSuccessCount() const {
-    return mSuccess.load( std::memory_order_relaxed );
+  uint64_t getSuccessCount() const {
+    uint64_t count = mSuccessBase.load( std::memory_order_relaxed );
+    for( Producer* producer = mProducers.load( std::memory_order_acquire ); producer; producer = producer->next )
+      count += producer->success.load( std::memory_order_relaxed );
+    return count;
+  }
+
+  void logMessage( ELog aLog, const StringRef& aMessage ) {
+    Producer& producer = currentProducer();
+    LogBatch* batch = takeBatch( producer );
+    if( batch->hasPrevious && batch->previous.first == aLog && aMessage == batch->previous.second ) {
+      ++batch->repeats;
+    } else {
+      flushRepeats( *batch );
+      retain( *batch, aLog, aMessage );
+    }
+    producer.batch.store( batch, std::memory_order_release );
+  }
+
+  /// Append the logs taken from another result as they are: they have already
+  /// been retained and collapsed, including the count of the dropped messages,
+  /// so they are not counted against the retention nor collapsed again
+  void appendLogs( const Logs& aLogs ) {
+    if( aLogs.empty() )
+      return;
+    Producer& producer = currentProducer();
+    LogBatch* batch = takeBatch( producer );
+    seal( *batch );
+    for( const Log& log : aLogs )
+      appendNode( *batch, log.first, log.second );
+    producer.batch.store( batch, std::memory_order_release );
+  }
+
+  /// Set the number of messages a thread keeps between two reports: the first
+  /// aFirst messages and the last aLast ones. To be called before logging.
+  void setRetention( size_t aFirst, size_t aLast ) {
+    mRetentionFirst = aFirst;
+    mRetentionLast = aLast;
+  }
+
+  /// Set the retention of the results created afterwards
+  static void setDefaultRetention( size_t aFirst, size_t aLast ) {
+    defaultRetentionFirst().store( aFirst, std::memory_order_relaxed );
+    defaultRetentionLast().store( aLast, std::memory_order_relaxed );
+  }
+
+  static size_t getDefaultRetentionFirst() {
+    return defaultRetentionFirst().load( std::memory_order_relaxed );
+  }
+
+  static size_t getDefaultRetentionLast() {
+    return defaultRetentionLast().load( std::memory_order_relaxed );
   }
 
-  void logMessage( ELog aLog, const std::string& aMessage ) {
-    std::lock_guard<std::mutex> lg( mLogMutex );
-    mLogs.emplace_back( aLog, aMessage );
+  /// Register the failure of an assertion site. Return false when the site has
+  /// already failed in this result, the failure is then only counted and
+  /// summarized by the next takeLogs instead of being logged again.
+  bool logSiteFail( const AssertionSite& aSite ) {
+    std::lock_guard<std::mutex> lg( mSiteMutex );
+    auto it = mSiteRepeats.find( &aSite );
+    if( it == mSiteRepeats.end() ) {
+      mSiteRepeats.emplace( &aSite, 0 );
+      return true;
+    }
+    ++it->second;
+    return false;
   }
 
+  bool hasSiteFailed( const AssertionSite& aSite ) {
+    std::lock_guard<std::mutex> lg( mSiteMutex );
+    return mSiteRepeats.find( &aSite ) != mSiteRepeats.end();
+  }
+
+  /// Move the pending logs to aLogs, a batch being filled by its thread is left
+  /// to the next call
   bool takeLogs( Logs& aLogs ) {
+    aLogs.clear();
+    drainLogs( aLogs );
     {
-      std::lock_guard<std::mutex> lg( mLogMutex );
-      std::swap( mLogs, aLogs );
+      std::lock_guard<std::mutex> lg( mSiteMutex );
+      for( auto& repeat : mSiteRepeats ) {
+        if( repeat.second > 0 ) {
+          std::string message = repeat.first->location() + ": failed " + countOf( repeat.second, "more time" );
+          aLogs.emplace_back( Error, mArena->copy( message ) );
+          repeat.second = 0;
+        }
+      }
+    }
+    bool hasNew = mHasNew.exchange( false, std::memory_order_relaxed );
+    for( Producer* producer = mProducers.load( std::memory_order_acquire ); producer; producer = producer->next ) {
+      if( producer->hasNew.load( std::memory_order_relaxed ) && producer->hasNew.exchange( false, std::memory_order_relaxed ) )
+        hasNew = true;
     }
-    return mHasNew.exchange( false, std::memory_order_relaxed ) || !aLogs.empty();
+    return hasNew || !aLogs.empty();
+  }
+
+  /// Overwrite the counters, used to restore a result transferred from another process
+  void restoreCounts( uint64_t aFailCount, bool aAborting, uint64_t aSuccessCount, bool aHasNew ) {
+    mFails.store( aFailCount * 2 + ( aAborting ? 1 : 0 ), std::memory_order_relaxed );
+    setSuccessCount( aSuccessCount );
+    mHasNew.store( aHasNew, std::memory_order_relaxed );
+  }
+
+  /// Add the counters and the pending logs of another result
+  void merge( TestCaseResult& aSource ) {
+    Logs logs;
+    bool hasNew = aSource.takeLogs( logs );
+    uint64_t fails = aSource.mFails.load( std::memory_order_relaxed );
+    mFails.fetch_add( fails & ~uint64_t( 1 ), std::memory_order_relaxed );
+    mFails.fetch_or( fails & 1u, std::memory_order_relaxed );
+    mSuccessBase.fetch_add( aSource.getSuccessCount(), std::memory_order_relaxed );
+    appendLogs( logs );
+    if( hasNew )
+      mHasNew.store( true, std::memory_order_relaxed );
+  }
+
+  /// Take the pending logs and copy the counters of another result. Used to
+  /// defer the reporting of a result that is about to be destroyed.
+  void takeState( TestCaseResult& aSource ) {
+    Logs logs;
+    bool hasNew = aSource.takeLogs( logs );
+    mFails.store( aSource.mFails.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+    setSuccessCount( aSource.getSuccessCount() );
+    appendLogs( logs );
+    if( hasNew )
+      mHasNew.store( true, std::memory_order_relaxed );
   }
 
 protected:
-  std::atomic<bool> mHasNew;  ///< Indicates when state should be reported
-  std::atomic<uint> mFails;   ///< number of fails * 2 + isAborted
-  std::atomic<uint> mSuccess; ///< number of succeeded test, fast tests are not logged
-  std::mutex mLogMutex;       ///< guard log buffer as other thread may add logs while the test-runner tries to print them
-  std::vector<Log> mLogs;
+  static const size_t kCacheLineSize = 64;
+
+  struct LogNode {
+    Log log;
+    LogNode* next;
+  };
+
+  /// Pending logs of a thread. The first messages are kept in the arena, the
+  /// following ones in a ring reusing its strings, so the memory used between
+  /// two drains is bounded.
+  struct LogBatch {
+    LogNode* first = nullptr;   ///< kept messages in logging order
+    LogNode* last = nullptr;
+    size_t headCount = 0;       ///< number of kept messages
+    std::vector<std::pair<ELog, std::string>> tail; ///< ring of the last messages
+    size_t tailNext = 0;        ///< next slot of the ring
+    size_t tailCount = 0;       ///< number of used slots of the ring
+    uint64_t dropped = 0;       ///< messages neither kept nor in the ring
+    uint64_t repeats = 0;       ///< repetitions of the previous message not logged yet
+    bool hasPrevious = false;
+    std::pair<ELog, std::string> previous; ///< the last logged message, collapsed when repeated
+  };
+
+  /// Counters and logs of a thread. The thread takes its batch out of the slot
+  /// while it logs and puts it back, a drain takes it out and leaves the emptied
+  /// batch as the spare: neither waits for the other.
+  /// Each producer is allocated on its own with a cache line of padding on both
+  /// sides of its fields, so no line holding them is shared with another thread
+  /// whatever the alignment of the allocation (operator new ignores alignas
+  /// beyond max_align_t before C++17).
+  struct Producer {
+    char paddingBefore[ kCacheLineSize ];
+    std::atomic<uint64_t> success; ///< number of succeeded checks of the thread, fast checks are not counted
+    std::atomic<bool> hasNew;      ///< a success is not reported yet
+    std::thread::id owner;
+    std::atomic<LogBatch*> batch;  ///< published batch, nullptr while logging or once drained
+    std::atomic<LogBatch*> spare;  ///< emptied batch, reused by the next message
+    Producer* next;
+    char paddingAfter[ kCacheLineSize ];
+  };
+
+  static uint64_t nextId() {
+    static std::atomic<uint64_t> sNextId( 0 );
+    return sNextId.fetch_add( 1, std::memory_order_relaxed );
+  }
+
+  static std::atomic<size_t>& defaultRetentionFirst() {
+    static std::atomic<size_t> sFirst( 10000 );
+    return sFirst;
+  }
+
+  static std::atomic<size_t>& defaultRetentionLast() {
+    static std::atomic<size_t> sLast( 1000 );
+    return sLast;
+  }
+
+  /// The producer of the calling thread, registered on its first check or message. The last
+  /// result used by the thread is cached, the results are identified by an id
+  /// never reused.
+  Producer& currentProducer() {
+    struct Cache {
+      uint64_t id;
+      Producer* producer;
+    };
+    static thread_local Cache sCache = { ~uint64_t( 0 ), nullptr };
+    if( sCache.id == mId )
+      return *sCache.producer;
+
+    std::thread::id self = std::this_thread::get_id();
+    Producer* head = mProducers.load( std::memory_order_acquire );
+    Producer* producer = head;
+    while( producer && producer->owner != self )
+      producer = producer->next;
+    if( !producer ) {
+      producer = new Producer();
+      producer->owner = self;
+      producer->success.store( 0, std::memory_order_relaxed );
+      producer->hasNew.store( false, std::memory_order_relaxed );
+      producer->batch.store( nullptr, std::memory_order_relaxed );
+      producer->spare.store( nullptr, std::memory_order_relaxed );
+      producer->next = head;
+      while( !mProducers.compare_exchange_weak( producer->next, producer, std::memory_order_release, std::memory_order_acquire ) ) {
+      }
+    }
+    sCache.id = mId;
+    sCache.producer = producer;
+    return *producer;
+  }
+
+  /// "1 time", "2 times"...
+  static std::string countOf( uint64_t aCount, const char* aNoun ) {
+    return std::to_string( aCount ) + " " + aNoun + ( aCount == 1 ? "" : "s" );
+  }
+
+  /// Take the batch of a thread, it is private to the thread until it is published again
+  static LogBatch* takeBatch( Producer& aProducer ) {
+    LogBatch* batch = aProducer.batch.exchange( nullptr, std::memory_order_acquire );
+    if( !batch ) {
+      // taken by a drain, continue with the recycled batch
+      batch = aProducer.spare.exchange( nullptr, std::memory_order_acquire );
+      if( !batch )
+        batch = new LogBatch();
+    }
+    return batch;
+  }
+
+  /// Log the collapsed repetitions of the previous message of a batch
+  void flushRepeats( LogBatch& aLogs ) {
+    if( aLogs.repeats == 0 )
+      return;
+    ELog log = aLogs.previous.first;
+    std::string message = "previous message repeated " + countOf( aLogs.repeats, "more time" );
+    aLogs.repeats = 0;
+    retain( aLogs, log, message );
+  }
+
+  /// Add a message at the end of the kept messages of a batch
+  void appendNode( LogBatch& aLogs, ELog aLog, const StringRef& aMessage ) {
+    LogNode* node = new( mArena->allocate( sizeof( LogNode ) ) ) LogNode{ Log( aLog, mArena->copy( aMessage ) ), nullptr };
+    if( aLogs.last )
+      aLogs.last->next = node;
+    else
+      aLogs.first = node;
+    aLogs.last = node;
+  }
+
+  /// Move the pending repetitions, the count of the dropped messages and the
+  /// ring of a batch after its kept messages, in their reporting order. The
+  /// following messages are retained from there.
+  void seal( LogBatch& aLogs ) {
+    flushRepeats( aLogs );
+    if( aLogs.dropped > 0 )
+      appendNode( aLogs, Warning, countOf( aLogs.dropped, "message" ) + " dropped" );
+    size_t ringSize = aLogs.tail.size();
+    for( size_t i = 0; i < aLogs.tailCount; ++i ) {
+      auto& log = aLogs.tail[ ( aLogs.tailNext + ringSize - aLogs.tailCount + i ) % ringSize ];
+      appendNode( aLogs, log.first, log.second );
+    }
+    aLogs.tailNext = 0;
+    aLogs.tailCount = 0;
+    aLogs.dropped = 0;
+    aLogs.hasPrevious = false;
+  }
+
+  /// Keep a message in the head, the ring or count it as dropped
+  void retain( LogBatch& aLogs, ELog aLog, const StringRef& aMessage ) {
+    aLogs.hasPrevious = true;
+    aLogs.previous.first = aLog;
+    aLogs.previous.second.assign( aMessage.data(), aMessage.size() );
+    if( aLogs.headCount < mRetentionFirst ) {
+      appendNode( aLogs, aLog, aMessage );
+      ++aLogs.headCount;
+      return;
+    }
+    size_t ringSize = mRetentionLast;
+    if( ringSize == 0 ) {
+      ++aLogs.dropped;
+      return;
+    }
+    if( aLogs.tail.empty() )
+      aLogs.tail.resize( ringSize ); // allocated on the first overflow
+    if( aLogs.tailCount == ringSize )
+      ++aLogs.dropped; // overwrite the oldest
+    else
+      ++aLogs.tailCount;
+    aLogs.tail[ aLogs.tailNext ].first = aLog;
+    aLogs.tail[ aLogs.tailNext ].second.assign( aMessage.data(), aMessage.size() );
+    aLogs.tailNext = ( aLogs.tailNext + 1 ) % ringSize;
+  }
+
+  /// Detach the published batch of each thread and append its logs in their
+  /// logging order, the threads in their registration order
+  void drainLogs( Logs& aLogs ) {
+    std::vector<Producer*> producers;
+    for( Producer* producer = mProducers.load( std::memory_order_acquire ); producer; producer = producer->next )
+      producers.push_back( producer );
+    for( auto it = producers.rbegin(); it != producers.rend(); ++it ) {
+      LogBatch* logs = ( *it )->batch.exchange( nullptr, std::memory_order_acquire );
+      if( !logs )
+        continue;
+      seal( *logs );
+      for( LogNode* node = logs->first; node; node = node->next )
+        aLogs.push_back( node->log );
+      logs->first = nullptr;
+      logs->last = nullptr;
+      logs->headCount = 0;
+      delete ( *it )->spare.exchange( logs, std::memory_order_release );
+    }
+  }
+
+  void setSuccessCount( uint64_t aCount ) {
+    for( Producer* producer = mProducers.load( std::memory_order_acquire ); producer; producer = producer->next )
+      producer->success.store( 0, std::memory_order_relaxed );
+    mSuccessBase.store( aCount, std::memory_order_relaxed );
+  }
+
+  std::atomic<bool> mHasNew;      ///< Indicates when state should be reported
+  std::atomic<uint64_t> mFails;   ///< number of fails * 2 + isAborted
+  LogArena mOwnArena;
+  LogArena* mArena;               ///< storage of the log messages
+  size_t mRetentionFirst;         ///< messages kept at the start of a drain, per thread
+  size_t mRetentionLast;          ///< messages kept at the end of a drain, per thread
+  std::atomic<uint64_t> mSuccessBase; ///< successes restored or merged from other results
+  const uint64_t mId;             ///< identify the result in the cache of the producers
+  std::atomic<Producer*> mProducers; ///< the threads which logged, the last registered first
+  std::mutex mSiteMutex;          ///< guard the failed sites, only taken on failures
+  std::map<const AssertionSite*, uint> mSiteRepeats; ///< failed sites and their failures not yet logged
 };
 
 //-----------------------------------------------------------------------------
@@ -107,19 +454,34 @@ public:
     }
   }
 
-  int getPassedTestCount() const {
+  void add( const TestRunResult& aResult ) {
+    mPassedTestCount += aResult.mPassedTestCount;
+    mFailedTestCount += aResult.mFailedTestCount;
+    mPassedAssertionCount += aResult.mPassedAssertionCount;
+    mFailedAssertionCount += aResult.mFailedAssertionCount;
+  }
+
+  /// Add the counters of a run executed in another process
+  void addCounts( uint64_t aPassedTests, uint64_t aFailedTests, uint64_t aPassedAssertions, uint64_t aFailedAssertions ) {
+    mPassedTestCount += aPassedTests;
+    mFailedTestCount += aFailedTests;
+    mPassedAssertionCount += aPassedAssertions;
+    mFailedAssertionCount += aFailedAssertions;
+  }
+
+  uint64_t getPassedTestCount() const {
     return mPassedTestCount;
   }
 
-  int getFailedTestCount() const {
+  uint64_t getFailedTestCount() const {
     return mFailedTestCount;
   }
 
-  int getPassedAssertionCount() const {
+  uint64_t getPassedAssertionCount() const {
     return mPassedAssertionCount;
   }
 
-  int getFailedAssertionCount() const {
+  uint64_t getFailedAssertionCount() const {
     return mFailedAssertionCount;
   }
 
@@ -128,10 +490,10 @@ public:
   }
 
 protected:
-  int mPassedTestCount;     ///< number of passed test cases
-  int mFailedTestCount;     ///< number of failed test cases
-  int mPassedAssertionCount;///< number of successful assertions (excluding the FAST checks)
-  int mFailedAssertionCount;///< number of failed assertions (including aborts)
+  uint64_t mPassedTestCount;     ///< number of passed test cases
+  uint64_t mFailedTestCount;     ///< number of failed test cases
+  uint64_t mPassedAssertionCount;///< number of successful assertions (excluding the FAST checks)
+  uint64_t mFailedAssertionCount;///< number of failed assertions (including aborts)
 };
 
 } // namespace ACatch
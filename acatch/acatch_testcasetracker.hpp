@@ -27,6 +27,8 @@ struct ITracker {
   virtual bool isSuccessfullyCompleted() const = 0;
   virtual bool isOpen() const = 0; // Started but not complete
   virtual bool hasChildren() const = 0;
+  virtual size_t childCount() const = 0;
+  virtual ITracker* childAt( size_t aIndex ) const = 0;
   virtual std::string getFullName() const = 0;
 
   virtual ITracker& parent() = 0;
@@ -34,6 +36,7 @@ struct ITracker {
 
   // actions
   virtual void close() = 0; // Successfully complete
+  virtual void closeForked() = 0; // Completed by a forked process, the cycle goes on
   virtual void skip() = 0;
   virtual void fail() = 0;
   virtual void markAsNeedingAnotherRun() = 0;
@@ -87,6 +90,10 @@ public:
     return *mCurrentTracker;
   }
 
+  ITracker& rootTracker() {
+    return *mRootTracker;
+  }
+
   void setCurrentTracker( ITracker* tracker ) {
     mCurrentTracker = tracker;
   }
@@ -135,6 +142,14 @@ public:
     return !mChildren.empty();
   }
 
+  virtual size_t childCount() const override {
+    return mChildren.size();
+  }
+
+  virtual ITracker* childAt( size_t aIndex ) const override {
+    return mChildren[ aIndex ].get();
+  }
+
   virtual void addChild( std::shared_ptr<ITracker> const& child ) override {
     mChildren.push_back( child );
   }
@@ -214,6 +229,11 @@ public:
     mCtx.completeCycle();
   }
 
+  virtual void closeForked() override {
+    mCycleState = CompletedSuccessfully;
+    moveToParent();
+  }
+
   virtual void skip() override {
     // Close any still open children (e.g. generators)
     while( &mCtx.currentTracker() != this )
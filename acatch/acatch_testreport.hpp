@@ -19,16 +19,23 @@ public:
   virtual void setProperty( const std::string& aProp, const std::string& aValue ) = 0;
 
   virtual void reportTestCases( const ConstTestCaseInfoRefs& aInfos ) = 0;
+  virtual void reportShard( uint aShardIndex, uint aShardCount, const ConstTestCaseInfoRefs& aInfos ) = 0;
 
   virtual void reportTestCaseSkip( const TestCaseInfo& aInfo ) = 0;
   virtual void reportTestCaseStart( const TestCaseInfo& aInfo ) = 0;
   virtual void reportTestSectionStart( const SectionInfo& aInfo ) = 0;
   virtual void reportTestSectionSkip( const SectionInfo& aInfo ) = 0;
-  virtual void reportTestSectionEnd( const SectionInfo& aInfo, TestCaseResult& aResult ) = 0;
-  virtual void reportTestCaseEnd( const TestCaseInfo& aInfo, TestCaseResult& aResult ) = 0;
+  virtual void reportTestSectionEnd( const SectionInfo& aInfo, TestCaseResult& aResult, const Timing& aTiming ) = 0;
+  virtual void reportTestCaseEnd( const TestCaseInfo& aInfo, TestCaseResult& aResult, const Timing& aTiming ) = 0;
   virtual void reportLogNow( TestCaseResult& aResult ) = 0;
 
+  /// Report the log of a test case whose process is terminating on a fatal error
+  virtual void reportFatal( TestCaseResult& aResult ) {
+    reportLogNow( aResult );
+  }
+
   virtual void reportTestRun( const ConstTestCaseInfoRefs& aInfos, TestRunResult& aRunResult ) = 0;
+  virtual void reportAssertionSites( const std::vector<const AssertionSite*>& aSites ) = 0;
 };
 
 } // namespace ACatch
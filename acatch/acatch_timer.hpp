@@ -0,0 +1,52 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+/// Measured duration of a test case cycle or a section
+struct ACATCH_API Timing {
+  double wallSeconds; ///< monotonic wall-clock time
+  double cpuSeconds;  ///< cpu time of the executing thread
+
+  Timing()
+      : wallSeconds( 0 )
+      , cpuSeconds( 0 ) {
+  }
+
+  Timing( double aWallSeconds, double aCpuSeconds )
+      : wallSeconds( aWallSeconds )
+      , cpuSeconds( aCpuSeconds ) {
+  }
+
+  Timing& operator+=( const Timing& aTiming ) {
+    wallSeconds += aTiming.wallSeconds;
+    cpuSeconds += aTiming.cpuSeconds;
+    return *this;
+  }
+};
+
+/// Measure the wall-clock and the thread cpu time
+class ACATCH_API Timer {
+public:
+  Timer()
+      : mStartWall( 0 )
+      , mStartCpu( 0 ) {
+  }
+
+  void start();
+  Timing getElapsed() const;
+
+  /// cpu time consumed by the calling thread in seconds
+  static double getThreadCpuSeconds();
+
+private:
+  double mStartWall; ///< monotonic clock in seconds, kept out of <chrono> for the light header
+  double mStartCpu;
+};
+
+} // namespace ACatch
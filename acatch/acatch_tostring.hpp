@@ -8,10 +8,57 @@
 
 namespace ACatch {
 
+//-----------------------------------------------------------------------------
+/// Output of the string conversions, appends to a buffer owned by the caller.
+/// The elements of a range or a tuple are appended to the same buffer instead
+/// of being concatenated from temporary strings.
+class StringSink
+{
+public:
+  explicit StringSink( std::string& aBuffer )
+      : mBuffer( aBuffer ) {
+  }
+
+  StringSink( const StringSink& ) = delete;
+  StringSink& operator=( const StringSink& ) = delete;
+
+  void append( const char* aData, size_t aSize ) {
+    mBuffer.append( aData, aSize );
+  }
+
+  StringSink& operator<<( const StringRef& aText ) {
+    mBuffer.append( aText.data(), aText.size() );
+    return *this;
+  }
+
+  StringSink& operator<<( char aChar ) {
+    mBuffer.push_back( aChar );
+    return *this;
+  }
+
+  std::string& buffer() {
+    return mBuffer;
+  }
+
+private:
+  std::string& mBuffer;
+};
+
+/// Maximum number of characters of a string rendered by toString, the middle
+/// of a longer string is elided and its size given. 0: no limit, 4096 by default.
+void setMaxStringLength( size_t aLength );
+size_t getMaxStringLength();
+
 // Why we're here.
 template <typename T>
 std::string toString( const T& value );
 
+/// Append the string conversion of a value to a sink, the protocol behind
+/// toString. Uses StringMaker<T>::append when defined, otherwise
+/// StringMaker<T>::convert.
+template <typename T>
+void appendString( StringSink& aSink, const T& aValue );
+
 // Built in overloads
 
 std::string toString( std::string const& value );
@@ -31,6 +78,26 @@ std::string toString( signed char value );
 std::string toString( unsigned char value );
 std::string toString( std::nullptr_t );
 
+void appendString( StringSink& aSink, std::string const& aValue );
+void appendString( StringSink& aSink, std::wstring const& aValue );
+void appendString( StringSink& aSink, const char* const aValue );
+void appendString( StringSink& aSink, char* const aValue );
+void appendString( StringSink& aSink, const wchar_t* const aValue );
+void appendString( StringSink& aSink, wchar_t* const aValue );
+void appendString( StringSink& aSink, int aValue );
+void appendString( StringSink& aSink, unsigned long aValue );
+void appendString( StringSink& aSink, unsigned int aValue );
+void appendString( StringSink& aSink, const double aValue );
+void appendString( StringSink& aSink, const float aValue );
+void appendString( StringSink& aSink, bool aValue );
+void appendString( StringSink& aSink, char aValue );
+void appendString( StringSink& aSink, signed char aValue );
+void appendString( StringSink& aSink, unsigned char aValue );
+void appendString( StringSink& aSink, std::nullptr_t );
+
+template <typename T, typename Allocator>
+void appendString( StringSink& aSink, std::vector<T, Allocator> const& aValue );
+
 namespace Detail {
 
 extern std::string unprintableString;
@@ -64,6 +131,10 @@ struct EnumStringMaker {
   static std::string convert( const T& ) {
     return unprintableString;
   }
+
+  static void append( StringSink& aSink, const T& ) {
+    aSink << unprintableString;
+  }
 };
 
 template <typename T>
@@ -72,26 +143,55 @@ struct EnumStringMaker<T, true> {
     return ::ACatch::toString(
         static_cast<typename std::underlying_type<T>::type>( v ) );
   }
+
+  static void append( StringSink& aSink, const T& v ) {
+    ::ACatch::appendString( aSink, static_cast<typename std::underlying_type<T>::type>( v ) );
+  }
 };
 
+/// Write a value with its operator<< to a stream appending to the sink. The
+/// stream of the thread is reused and its format reset, a nested call gets
+/// its own stream.
+void streamToSink( StringSink& aSink, void ( *aWrite )( std::ostream&, const void* ), const void* aValue );
+
+template <typename T>
+void writeToStream( std::ostream& aStream, const void* aValue ) {
+  aStream << *static_cast<const T*>( aValue );
+}
+
 template <bool C>
 struct StringMakerBase {
   template <typename T>
   static std::string convert( const T& v ) {
     return EnumStringMaker<T>::convert( v );
   }
+
+  template <typename T>
+  static void append( StringSink& aSink, const T& v ) {
+    EnumStringMaker<T>::append( aSink, v );
+  }
 };
 
 template <>
 struct StringMakerBase<true> {
   template <typename T>
   static std::string convert( const T& _value ) {
-    std::ostringstream oss;
-    oss << _value;
-    return oss.str();
+    std::string s;
+    StringSink sink( s );
+    append( sink, _value );
+    return s;
+  }
+
+  template <typename T>
+  static void append( StringSink& aSink, const T& _value ) {
+    streamToSink( aSink, &writeToStream<T>, &_value );
   }
 };
 
+void appendRawMemory( StringSink& aSink, const void* object, std::size_t size );
+
+/// Append [aBegin, aEnd) of aData with the control characters escaped
+void appendEscaped( StringSink& aSink, const char* aData, size_t aBegin, size_t aEnd );
 std::string rawMemoryToString( const void* object, std::size_t size );
 
 template <typename T>
@@ -114,6 +214,14 @@ struct StringMaker<T*> {
     else
       return Detail::rawMemoryToString( p );
   }
+
+  template <typename U>
+  static void append( StringSink& aSink, U* p ) {
+    if( !p )
+      aSink << "null";
+    else
+      Detail::appendRawMemory( aSink, &p, sizeof( p ) );
+  }
 };
 
 template <typename R, typename C>
@@ -129,6 +237,9 @@ struct StringMaker<R C::*> {
 namespace Detail {
 template <typename InputIterator>
 std::string rangeToString( InputIterator first, InputIterator last );
+
+template <typename InputIterator>
+void appendRange( StringSink& aSink, InputIterator first, InputIterator last );
 } // namespace Detail
 
 // template<typename T, typename Allocator>
@@ -143,20 +254,26 @@ std::string toString( std::vector<T, Allocator> const& v ) {
   return Detail::rangeToString( v.begin(), v.end() );
 }
 
+template <typename T, typename Allocator>
+void appendString( StringSink& aSink, std::vector<T, Allocator> const& aValue ) {
+  Detail::appendRange( aSink, aValue.begin(), aValue.end() );
+}
+
 // toString for tuples
 namespace TupleDetail {
 template <typename Tuple, std::size_t N = 0,
           bool = ( N < std::tuple_size<Tuple>::value )>
 struct ElementPrinter {
-  static void print( const Tuple& tuple, std::ostream& os ) {
-    os << ( N ? ", " : " " ) << ::ACatch::toString( std::get<N>( tuple ) );
-    ElementPrinter<Tuple, N + 1>::print( tuple, os );
+  static void print( const Tuple& tuple, StringSink& aSink ) {
+    aSink << ( N ? ", " : " " );
+    ::ACatch::appendString( aSink, std::get<N>( tuple ) );
+    ElementPrinter<Tuple, N + 1>::print( tuple, aSink );
   }
 };
 
 template <typename Tuple, std::size_t N>
 struct ElementPrinter<Tuple, N, false> {
-  static void print( const Tuple&, std::ostream& ) {
+  static void print( const Tuple&, StringSink& ) {
   }
 };
 } // namespace TupleDetail
@@ -165,11 +282,16 @@ template <typename... Types>
 struct StringMaker<std::tuple<Types...>> {
 
   static std::string convert( const std::tuple<Types...>& tuple ) {
-    std::ostringstream os;
-    os << '{';
-    TupleDetail::ElementPrinter<std::tuple<Types...>>::print( tuple, os );
-    os << " }";
-    return os.str();
+    std::string s;
+    StringSink sink( s );
+    append( sink, tuple );
+    return s;
+  }
+
+  static void append( StringSink& aSink, const std::tuple<Types...>& tuple ) {
+    aSink << '{';
+    TupleDetail::ElementPrinter<std::tuple<Types...>>::print( tuple, aSink );
+    aSink << " }";
   }
 };
 
@@ -178,6 +300,18 @@ template <typename T>
 std::string makeString( const T& value ) {
   return StringMaker<T>::convert( value );
 }
+
+/// StringMaker<T>::append when declared, the specializations written before
+/// the sinks only have convert
+template <typename T>
+auto appendWithMaker( StringSink& aSink, const T& aValue, int ) -> decltype( StringMaker<T>::append( aSink, aValue ), void() ) {
+  StringMaker<T>::append( aSink, aValue );
+}
+
+template <typename T>
+void appendWithMaker( StringSink& aSink, const T& aValue, long ) {
+  aSink << StringMaker<T>::convert( aValue );
+}
 } // namespace Detail
 
 /// \brief converts any type to a string
@@ -189,21 +323,37 @@ std::string makeString( const T& value ) {
 /// to provide an ostream overload for.
 template <typename T>
 std::string toString( const T& value ) {
-  return StringMaker<T>::convert( value );
+  std::string s;
+  StringSink sink( s );
+  Detail::appendWithMaker( sink, value, 0 );
+  return s;
+}
+
+template <typename T>
+void appendString( StringSink& aSink, const T& aValue ) {
+  Detail::appendWithMaker( aSink, aValue, 0 );
 }
 
 namespace Detail {
 template <typename InputIterator>
 std::string rangeToString( InputIterator first, InputIterator last ) {
-  std::ostringstream oss;
-  oss << "{ ";
+  std::string s;
+  StringSink sink( s );
+  appendRange( sink, first, last );
+  return s;
+}
+
+template <typename InputIterator>
+void appendRange( StringSink& aSink, InputIterator first, InputIterator last ) {
+  aSink << "{ ";
   if( first != last ) {
-    oss << ::ACatch::toString( *first );
-    for( ++first; first != last; ++first )
-      oss << ", " << ::ACatch::toString( *first );
+    ::ACatch::appendString( aSink, *first );
+    for( ++first; first != last; ++first ) {
+      aSink << ", ";
+      ::ACatch::appendString( aSink, *first );
+    }
   }
-  oss << " }";
-  return oss.str();
+  aSink << " }";
 }
 } // namespace Detail
 
@@ -0,0 +1,74 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+namespace ACatch {
+
+//-----------------------------------------------------------------------------
+/// Watch the running test cases and report the ones exceeding their time
+/// budget. The watching thread is started on the first use.
+class ACATCH_API Watchdog
+{
+public:
+  /// Exit code of the process terminated by the watchdog
+  static const int kTimeoutExitCode = 124;
+
+  Watchdog();
+  ~Watchdog();
+
+  Watchdog( const Watchdog& ) = delete;
+  Watchdog( const Watchdog&& ) = delete;
+  Watchdog& operator=( const Watchdog& ) = delete;
+
+  /// Start watching the test case running in the given context
+  void arm( RunContext& aContext, const TestCaseInfo& aInfo, double aSeconds );
+  void disarm( RunContext& aContext );
+
+private:
+  struct Entry {
+    const TestCaseInfo* info;
+    double seconds;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  std::mutex mMutex;
+  std::condition_variable mWakeUp;
+  std::thread mThread;
+  bool mStop;
+  std::map<RunContext*, Entry> mEntries;
+
+  void watch();
+};
+
+
+/// Watch the test case running in the given context for the lifetime of the
+/// scope, the test case is not watched when it has no time budget.
+class ACATCH_API WatchdogScope
+{
+public:
+  WatchdogScope( Watchdog& aWatchdog, RunContext& aContext, const TestCaseInfo& aInfo, double aSeconds )
+      : mWatchdog( aSeconds > 0 ? &aWatchdog : nullptr )
+      , mContext( aContext ) {
+    if( mWatchdog )
+      mWatchdog->arm( aContext, aInfo, aSeconds );
+  }
+
+  ~WatchdogScope() {
+    if( mWatchdog )
+      mWatchdog->disarm( mContext );
+  }
+
+  WatchdogScope( const WatchdogScope& ) = delete;
+  WatchdogScope( const WatchdogScope&& ) = delete;
+  WatchdogScope& operator=( const WatchdogScope& ) = delete;
+
+private:
+  Watchdog* mWatchdog;
+  RunContext& mContext;
+};
+
+} // namespace ACatch
@@ -0,0 +1,82 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// Allocation benchmark (ACATCH_COMPILE_BENCHMARK): counts the calls of
+// operator new while the selected test cases run, the report is discarded.
+//   acatch_allocations allocations.info      1 EXPECT + 1 ACATCH_INFO (32 chars)
+//   acatch_allocations allocations.verbose   1 EXPECT_VERBOSE + 1 ACATCH_INFO (9 chars)
+// each for 100 sections x 1000 iterations.
+
+#include "acatch/acatch.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<unsigned long> sAllocations( 0 );
+
+const int kSections = 100;
+const int kIterations = 1000;
+
+} // namespace
+
+void* operator new( size_t aSize ) {
+  sAllocations.fetch_add( 1, std::memory_order_relaxed );
+  if( void* p = std::malloc( aSize ? aSize : 1 ) )
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete( void* aPtr ) noexcept {
+  std::free( aPtr );
+}
+
+void operator delete( void* aPtr, size_t ) noexcept {
+  std::free( aPtr );
+}
+
+
+ACATCH_TEST_CASE( "allocations.info" ) {
+  for( int s = 0; s < kSections; ++s ) {
+    ACATCH_SECTION( std::to_string( s ) ) {
+      for( int i = 0; i < kIterations; ++i ) {
+        ACATCH_REQUIRE( EXPECT, i >= 0 );
+        ACATCH_INFO( "iteration of the diagnostic loop" );
+      }
+    }
+  }
+}
+
+ACATCH_TEST_CASE( "allocations.verbose" ) {
+  for( int s = 0; s < kSections; ++s ) {
+    ACATCH_SECTION( std::to_string( s ) ) {
+      for( int i = 0; i < kIterations; ++i ) {
+        ACATCH_REQUIRE( EXPECT_VERBOSE, i >= 0 );
+        ACATCH_INFO( "iteration" );
+      }
+    }
+  }
+}
+
+
+int main( int aArgc, char** aArgv ) {
+  if( !ACatch::theACatch().parseCommandLine( aArgc, aArgv ) )
+    return 2;
+  if( !ACatch::theACatch().runPreinits() )
+    return 2;
+
+  unsigned long before = sAllocations.load();
+  bool ok = ACatch::theACatch().runAllTests();
+  unsigned long allocations = sAllocations.load() - before;
+
+  std::cerr << "allocations: " << allocations << "\n";
+  ACatch::theACatchShutdown();
+  return ok ? 0 : 1;
+}
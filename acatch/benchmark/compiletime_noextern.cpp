@@ -0,0 +1,13 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// the light header with the common comparisons instantiated in this file
+#define ACATCH_NO_EXTERN_TEMPLATES
+#include "acatch/acatch_light.hpp"
+
+#include "acatch/benchmark/compiletime_tests.ipp"
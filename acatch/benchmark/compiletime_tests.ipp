@@ -0,0 +1,70 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// A test file of the usual shape, compiled with acatch.hpp and acatch_light.hpp
+// by the compile time benchmark (ACATCH_COMPILE_BENCHMARK)
+
+#define ACATCH_COMPILETIME_CASE( N )                                           \
+  ACATCH_TEST_CASE( "compiletime." #N ) {                                      \
+    int count = N;                                                             \
+    long total = 2 * N;                                                        \
+    double ratio = N / 3.0;                                                    \
+    bool ready = N > 0;                                                        \
+    std::string name = "case " #N;                                             \
+    std::vector<int> values( N, 1 );                                           \
+    ACATCH_SECTION( "scalars" ) {                                              \
+      ACATCH_REQUIRE( EXPECT, count == N );                                    \
+      ACATCH_REQUIRE( EXPECT, total != 0 );                                    \
+      ACATCH_REQUIRE( EXPECT, ratio < count );                                 \
+      ACATCH_REQUIRE( ASSERT, ready );                                         \
+      ACATCH_REQUIRE_ALL( EXPECT, count >= 0, count <= N );                    \
+    }                                                                          \
+    ACATCH_SECTION( "containers" ) {                                           \
+      ACATCH_REQUIRE( EXPECT, values.size() == static_cast<size_t>( N ) );     \
+      ACATCH_REQUIRE( EXPECT, values == std::vector<int>( N, 1 ) );            \
+      ACATCH_REQUIRE( EXPECT, name == std::string( "case " #N ) );             \
+      ACATCH_REQUIRE( EXPECT, name.size() > 4u );                              \
+    }                                                                          \
+  }
+
+namespace ACatchCompileTime {
+
+ACATCH_COMPILETIME_CASE( 1 )
+ACATCH_COMPILETIME_CASE( 2 )
+ACATCH_COMPILETIME_CASE( 3 )
+ACATCH_COMPILETIME_CASE( 4 )
+ACATCH_COMPILETIME_CASE( 5 )
+ACATCH_COMPILETIME_CASE( 6 )
+ACATCH_COMPILETIME_CASE( 7 )
+ACATCH_COMPILETIME_CASE( 8 )
+ACATCH_COMPILETIME_CASE( 9 )
+ACATCH_COMPILETIME_CASE( 10 )
+ACATCH_COMPILETIME_CASE( 11 )
+ACATCH_COMPILETIME_CASE( 12 )
+ACATCH_COMPILETIME_CASE( 13 )
+ACATCH_COMPILETIME_CASE( 14 )
+ACATCH_COMPILETIME_CASE( 15 )
+ACATCH_COMPILETIME_CASE( 16 )
+ACATCH_COMPILETIME_CASE( 17 )
+ACATCH_COMPILETIME_CASE( 18 )
+ACATCH_COMPILETIME_CASE( 19 )
+ACATCH_COMPILETIME_CASE( 20 )
+ACATCH_COMPILETIME_CASE( 21 )
+ACATCH_COMPILETIME_CASE( 22 )
+ACATCH_COMPILETIME_CASE( 23 )
+ACATCH_COMPILETIME_CASE( 24 )
+ACATCH_COMPILETIME_CASE( 25 )
+ACATCH_COMPILETIME_CASE( 26 )
+ACATCH_COMPILETIME_CASE( 27 )
+ACATCH_COMPILETIME_CASE( 28 )
+ACATCH_COMPILETIME_CASE( 29 )
+ACATCH_COMPILETIME_CASE( 30 )
+ACATCH_COMPILETIME_CASE( 31 )
+ACATCH_COMPILETIME_CASE( 32 )
+
+} // namespace ACatchCompileTime
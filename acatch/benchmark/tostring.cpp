@@ -0,0 +1,89 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// Formatting benchmark (ACATCH_COMPILE_BENCHMARK): the wall-clock time and the
+// heap allocations of one call of each conversion path.
+//   acatch_tostring
+
+#include "acatch/acatch.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <tuple>
+
+namespace {
+
+std::atomic<unsigned long> sAllocations( 0 );
+
+struct Point {
+  int x;
+  double y;
+};
+
+std::ostream& operator<<( std::ostream& aStream, const Point& aPoint ) {
+  return aStream << "(" << aPoint.x << ", " << aPoint.y << ")";
+}
+
+/// Call aConvert aCount times and print the averages per call
+template <typename TConvert>
+void measure( const char* aName, int aCount, TConvert aConvert ) {
+  size_t length = 0;
+  unsigned long allocations = sAllocations.load();
+  ACatch::Timer timer;
+  timer.start();
+  for( int i = 0; i < aCount; ++i )
+    length += aConvert().size();
+  double seconds = timer.getElapsed().wallSeconds;
+  allocations = sAllocations.load() - allocations;
+  std::printf( "%-34s %10.1f ns %8.1f allocations %8zu chars\n", aName, seconds / aCount * 1e9,
+               double( allocations ) / aCount, length / aCount );
+}
+
+} // namespace
+
+void* operator new( size_t aSize ) {
+  sAllocations.fetch_add( 1, std::memory_order_relaxed );
+  if( void* p = std::malloc( aSize ? aSize : 1 ) )
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete( void* aPtr ) noexcept {
+  std::free( aPtr );
+}
+
+void operator delete( void* aPtr, size_t ) noexcept {
+  std::free( aPtr );
+}
+
+
+int main() {
+  using namespace ACatch;
+
+  std::vector<int> ints( 1000 );
+  std::vector<double> doubles( 1000 );
+  std::vector<Point> points( 1000 );
+  for( int i = 0; i < 1000; ++i ) {
+    ints[ i ] = i * 37;
+    doubles[ i ] = i * 0.37;
+    points[ i ] = Point{ i, i * 0.5 };
+  }
+  std::vector<std::tuple<int, float, std::string>> tuples( 200, std::make_tuple( 7, 2.5f, std::string( "abc" ) ) );
+  int value = 123456;
+
+  measure( "toString( int )", 200000, [&] { return toString( value ); } );
+  measure( "toString( double )", 200000, [&] { return toString( 3.14159 ); } );
+  measure( "rawMemoryToString( int* )", 200000, [&] { return Detail::rawMemoryToString( &value ); } );
+  measure( "toString( vector<int>[1000] )", 200, [&] { return toString( ints ); } );
+  measure( "toString( vector<double>[1000] )", 200, [&] { return toString( doubles ); } );
+  measure( "toString( vector<Point>[1000] )", 200, [&] { return toString( points ); } );
+  measure( "toString( vector<tuple>[200] )", 200, [&] { return toString( tuples ); } );
+  return 0;
+}
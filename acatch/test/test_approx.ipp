@@ -0,0 +1,63 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 170000
+
+namespace ACatchTest {
+
+ACATCH_TEST_CASE( "acatch.approx" ) {
+  using namespace ACatch;
+
+  ACATCH_SECTION( "tolerances" ) {
+    ACATCH_REQUIRE( EXPECT, 1.0 == Approx( 1.0 ) );
+    ACATCH_REQUIRE( EXPECT, 1.0 + 1e-7 == Approx( 1.0 ) );
+    ACATCH_REQUIRE( EXPECT, 1.1 != Approx( 1.0 ) );
+    ACATCH_REQUIRE( EXPECT, 1.1 == Approx( 1.0 ).epsilon( 0.2 ) );
+    ACATCH_REQUIRE( EXPECT, 0.0 != Approx( 1e-10 ) );
+    ACATCH_REQUIRE( EXPECT, 0.0 == Approx( 1e-10 ).margin( 1e-9 ) );
+    ACATCH_REQUIRE( EXPECT, Approx( 3 ) == 3 );
+  }
+
+  ACATCH_SECTION( "ulps" ) {
+    float one = 1.0f;
+    float next = std::nextafter( one, 2.0f );
+    float after = std::nextafter( next, 2.0f );
+    Tolerance ulps = Tolerance().epsilon( 0 ).ulps( 1 );
+    ACATCH_REQUIRE( EXPECT, next == Approx( 1.0, ulps ) );
+    ACATCH_REQUIRE( EXPECT, after != Approx( 1.0, ulps ) );
+    ACATCH_REQUIRE( EXPECT, ulps.matches( -0.0, 0.0 ) );
+    ACATCH_REQUIRE( EXPECT, ulps.matches( std::numeric_limits<double>::denorm_min(), -std::numeric_limits<double>::denorm_min() ) == false );
+    ACATCH_REQUIRE( EXPECT, !ulps.matches( std::nan( "" ), std::nan( "" ) ) );
+    ACATCH_REQUIRE( EXPECT, ulps.matches( std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() ) );
+  }
+
+  ACATCH_SECTION( "display" ) {
+    ACATCH_REQUIRE( EXPECT, toString( Approx( 0.1 ).margin( 0.5 ) ) == "Approx( 0.10000000000000001 ) [epsilon 1.19209e-05, margin 0.5, ulps 0]" );
+  }
+
+  ACATCH_SECTION( "range" ) {
+    std::vector<float> a( 1000 );
+    for( size_t i = 0; i < a.size(); ++i )
+      a[ i ] = static_cast<float>( i ) * 0.25f;
+    std::vector<float> b = a;
+    b[ 10 ] += 1e-5f;
+    ACATCH_REQUIRE_RANGE_APPROX( EXPECT, a, b, Tolerance().epsilon( 1e-5 ) );
+    b[ 300 ] += 1.0f;
+    b[ 700 ] = std::nanf( "" );
+    auto cmp = rangeApprox( a, b, Tolerance().epsilon( 1e-5 ) );
+    ACATCH_REQUIRE( ASSERT, !cmp );
+    ACATCH_REQUIRE( EXPECT, cmp.getStats().count == 2 );
+    ACATCH_REQUIRE( EXPECT, cmp.getStats().first == 300 );
+    ACATCH_REQUIRE( EXPECT, cmp.getStats().worst == 700 );
+    ACATCH_REQUIRE( EXPECT, startsWith( toString( cmp ), "2 of 1000 elements out of tolerance" ) );
+    ACATCH_REQUIRE( EXPECT, toString( cmp ).find( "first [300] 75f != 76f" ) != std::string::npos );
+  }
+}
+
+} // namespace ACatchTest
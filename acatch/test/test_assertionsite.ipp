@@ -0,0 +1,73 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 120000
+
+namespace ACatchTest {
+
+ACATCH_TEST_CASE( "acatch.assertion_site" ) {
+  using namespace ACatch;
+
+  static AssertionSite site( "file.cpp", 12, "EXPECT", "a == b" );
+
+  ACATCH_SECTION( "counters" ) {
+    const bool counting = AssertionSite::isCountingHits();
+    uint64_t hits = site.getHits();
+    uint64_t fails = site.getFails();
+    AssertionSite::setCountHits( true );
+    site.hit();
+    site.hit();
+    AssertionSite::setCountHits( false );
+    site.hit(); // reached but not counted
+    AssertionSite::setCountHits( counting );
+    site.fail( "1 == 2" );
+    site.fail( "3 == 4" );
+    ACATCH_REQUIRE( EXPECT, site.isReached() );
+    ACATCH_REQUIRE( EXPECT, site.getHits() == hits + 2 );
+    ACATCH_REQUIRE( EXPECT, site.getFails() == fails + 2 );
+    ACATCH_REQUIRE( EXPECT, site.getFirstFailure() == "1 == 2" );
+    ACATCH_REQUIRE( EXPECT, site.location() == "file.cpp:12" );
+
+    // registered once whatever the number of hits
+    size_t entries = 0;
+    for( const AssertionSite* s : AssertionSite::getAll() )
+      entries += s == &site;
+    ACATCH_REQUIRE( EXPECT, entries <= 1 );
+  }
+
+  ACATCH_SECTION( "repeated failures" ) {
+    TestCaseResult result;
+    ACATCH_REQUIRE( EXPECT, !result.hasSiteFailed( site ) );
+    ACATCH_REQUIRE( EXPECT, result.logSiteFail( site ) );
+    ACATCH_REQUIRE( EXPECT, result.hasSiteFailed( site ) );
+    ACATCH_REQUIRE( EXPECT, !result.logSiteFail( site ) );
+    ACATCH_REQUIRE( EXPECT, !result.logSiteFail( site ) );
+
+    TestCaseResult::Logs logs;
+    result.takeLogs( logs );
+    ACATCH_REQUIRE( EXPECT, logs.size() == 1 );
+    ACATCH_REQUIRE( EXPECT, logs[ 0 ].second == "file.cpp:12: failed 2 more times" );
+
+    logs.clear();
+    result.takeLogs( logs );
+    ACATCH_REQUIRE( EXPECT, logs.empty() );
+    ACATCH_REQUIRE( EXPECT, !result.logSiteFail( site ) );
+  }
+
+  ACATCH_SECTION( "reached sites" ) {
+    const uint line = __LINE__ + 1;
+    ACATCH_REQUIRE( EXPECT, site.location() == "file.cpp:12" );
+    bool found = false;
+    for( const AssertionSite* s : AssertionSite::getAll() )
+      found = found || ( s->line == line && s->isReached() );
+    ACATCH_REQUIRE( EXPECT, found );
+  }
+}
+
+} // namespace ACatchTest
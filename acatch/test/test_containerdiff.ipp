@@ -0,0 +1,93 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 190000
+
+namespace ACatchTest {
+
+template <typename C>
+std::string expandEqual( const C& aLhs, const C& aRhs ) {
+  ACatch::MultiExpressionCapture capture( ACatch::MultiExpressionCapture::All );
+  capture.evaluate( "lhs == rhs", ( ACatch::ExpressionDecomposer() <= aLhs ) == aRhs );
+  return capture.getValues();
+}
+
+ACATCH_TEST_CASE( "acatch.container_diff" ) {
+  using namespace ACatch;
+
+  std::vector<int> a( 100000 );
+  for( size_t i = 0; i < a.size(); ++i )
+    a[ i ] = static_cast<int>( i );
+  std::vector<int> b = a;
+
+  ACATCH_SECTION( "small containers in full" ) {
+    std::vector<int> c = { 1, 2, 3 };
+    std::vector<int> d = { 1, 5, 3 };
+    ACATCH_REQUIRE( EXPECT, expandEqual( c, d ) == "{ 1, 2, 3 } \"==\" { 1, 5, 3 }" );
+  }
+
+  ACATCH_SECTION( "sequence hunks" ) {
+    b[ 10 ] = -1;
+    b.erase( b.begin() + 500, b.begin() + 503 );
+    b.insert( b.begin() + 90000, 7 );
+    std::string diff = expandEqual( a, b );
+    ACATCH_REQUIRE( EXPECT, startsWith( diff, "{ 100000 elements } \"==\" { 99998 elements }" ) );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  sizes differ: 100000 != 99998" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  first mismatch at [10], 3 changes" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  - [10] { 10 }\n  + [10] { -1 }" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  - [500..502] { 500 (0x1f4), 501 (0x1f5), 502 (0x1f6) }" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  + [90000] { 7 }" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, diff.size() < 400 );
+  }
+
+  ACATCH_SECTION( "budget exceeded" ) {
+    for( size_t i = 1000; i < 2000; ++i )
+      b[ i ] = -1;
+    std::string diff = expandEqual( a, b );
+    ACATCH_REQUIRE( EXPECT, diff.find( "too many changes to diff" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  + [1000..1999] { -1, -1, -1, -1, -1, -1, -1, -1, ... 992 more }" ) != std::string::npos );
+  }
+
+  ACATCH_SECTION( "deque" ) {
+    std::deque<int> c( a.begin(), a.begin() + 100 );
+    std::deque<int> d = c;
+    d.push_front( 3 );
+    ACATCH_REQUIRE( EXPECT, expandEqual( c, d ).find( "\n  + [0] { 3 }" ) != std::string::npos );
+  }
+
+  ACATCH_SECTION( "map" ) {
+    std::map<int, std::string> c;
+    for( int i = 0; i < 100; ++i )
+      c[ i ] = "v";
+    std::map<int, std::string> d = c;
+    d.erase( 3 );
+    d[ 200 ] = "w";
+    d[ 50 ] = "x";
+    std::string diff = expandEqual( c, d );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  1 only in lhs, 1 only in rhs, 1 changed" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  - 3: \"v\"\n  + 200: \"w\"\n  ~ 50: \"v\" -> \"x\"" ) != std::string::npos );
+  }
+
+  ACATCH_SECTION( "diff" ) {
+    auto equal = []( const void* aContext, size_t aLhs, size_t aRhs ) {
+      const std::pair<const char*, const char*>& strings = *static_cast<const std::pair<const char*, const char*>*>( aContext );
+      return strings.first[ aLhs ] == strings.second[ aRhs ];
+    };
+    std::pair<const char*, const char*> strings( "abcabba", "cbabac" );
+    std::vector<Detail::DiffHunk> hunks;
+    ACATCH_REQUIRE( ASSERT, Detail::diffSequences( 7, 6, equal, &strings, 100, 1000, hunks ) );
+    size_t edits = 0;
+    for( const Detail::DiffHunk& hunk : hunks )
+      edits += hunk.lhsCount + hunk.rhsCount;
+    ACATCH_REQUIRE( EXPECT, edits == 5 );
+    ACATCH_REQUIRE( EXPECT, !Detail::diffSequences( 7, 6, equal, &strings, 4, 1000, hunks ) );
+  }
+}
+
+} // namespace ACatchTest
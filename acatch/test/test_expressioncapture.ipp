@@ -0,0 +1,44 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 110000
+
+namespace ACatchTest {
+
+ACATCH_TEST_CASE( "acatch.expression_capture" ) {
+  using namespace ACatch;
+
+  int calls = 0;
+  auto next = [&calls]() { return ++calls; };
+
+  ACATCH_SECTION( "single evaluation" ) {
+    ACATCH_REQUIRE( EXPECT, next() == 1 );
+    ACATCH_REQUIRE( EXPECT_VERBOSE, next() == 2 );
+    ACATCH_REQUIRE( EXPECT, calls == 2 );
+  }
+
+  ACATCH_SECTION( "short circuit" ) {
+    ACATCH_REQUIRE_ANY( EXPECT, next() == 1, next() == 1 );
+    ACATCH_REQUIRE_ALL( EXPECT, next() == 2, next() == 3 );
+    ACATCH_REQUIRE( EXPECT, calls == 3 );
+  }
+
+  ACATCH_SECTION( "expansion" ) {
+    MultiExpressionCapture capture( MultiExpressionCapture::All );
+    std::string text = "abc";
+    ACATCH_REQUIRE( EXPECT, capture.evaluate( "text.size() == 3", ( ExpressionDecomposer() <= text.size() ) == 3 ) );
+    ACATCH_REQUIRE( EXPECT, capture.getExpressions().empty() );
+    ACATCH_REQUIRE( EXPECT, !capture.evaluate( "next() > 1", ExpressionDecomposer() <= next() > 1 ) );
+    ACATCH_REQUIRE( EXPECT, capture.getExpressions().size() == 1 );
+    ACATCH_REQUIRE( EXPECT, capture.getExpressions()[ 0 ].raw == "next() > 1" );
+    ACATCH_REQUIRE( EXPECT, capture.getExpressions()[ 0 ].expanded == "1 \">\" 1" );
+  }
+}
+
+} // namespace ACatchTest
@@ -0,0 +1,112 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 90000
+
+namespace ACatchTest {
+
+namespace {
+
+int forkedPrefixRuns = 0;
+
+/// Every check sees a single run of the code before the sections
+void forkedPrefixTest() {
+  ++forkedPrefixRuns;
+  ACATCH_SECTION( "a" ) {
+    ACATCH_SECTION( "a1" ) {
+      ACATCH_REQUIRE( EXPECT, forkedPrefixRuns == 1 );
+    }
+    ACATCH_SECTION( "a2" ) {
+      ACATCH_REQUIRE( EXPECT, forkedPrefixRuns == 1 );
+    }
+  }
+  ACATCH_SECTION( "b" ) {
+    ACATCH_REQUIRE( EXPECT, forkedPrefixRuns == 1 );
+  }
+  ACATCH_REQUIRE( EXPECT, forkedPrefixRuns == 1 );
+}
+
+/// The code after the sections runs in the children and in the parent, which
+/// does not see the side effects of the sections
+void forkedTrailingTest() {
+  bool sectionRan = false;
+  ACATCH_SECTION( "a" ) {
+    sectionRan = true;
+  }
+  ACATCH_SECTION( "b" ) {
+    sectionRan = true;
+  }
+  ACATCH_REQUIRE( EXPECT, sectionRan );
+}
+
+} // namespace
+
+ACATCH_TEST_CASE( "acatch.fork_sections", ACatch::TestCaseInfo::ForkSections ) {
+  using namespace ACatch;
+
+  // the sections start from a copy of the state and their side effects are
+  // not seen by the parent (without fork support or in a thread they are replayed)
+  static int sectionRuns = 0;
+  const int expectedRuns = theACatch().context().isForkingSections() ? 0 : sectionRuns;
+  std::vector<int> data( 2, 1 );
+
+  ACATCH_SECTION( "s1" ) {
+    data[ 0 ] = 2;
+    ACATCH_SECTION( "s1.1" ) {
+      ACATCH_REQUIRE_ALL( EXPECT, sectionRuns == expectedRuns, data[ 0 ] == 2, data[ 1 ] == 1 );
+      ++sectionRuns;
+    }
+    ACATCH_SECTION( "s1.2" ) {
+      data[ 1 ] = 3;
+      ACATCH_REQUIRE_ALL( EXPECT, sectionRuns == expectedRuns, data[ 0 ] == 2, data[ 1 ] == 3 );
+      ++sectionRuns;
+    }
+  }
+
+  ACATCH_SECTION( "s2" ) {
+    ACATCH_REQUIRE_ALL( EXPECT, sectionRuns == expectedRuns, data[ 0 ] == 1, data[ 1 ] == 1 );
+    ++sectionRuns;
+  }
+}
+
+ACATCH_TEST_CASE( "acatch.fork_sections.prefix" ) {
+  using namespace ACatch;
+  if( !SectionForker::isSupported() )
+    return; // the sections are replayed, the prefix runs once per leaf
+
+  // run in a worker, a new process where the prefix has never run
+  FunctionTestCase test( forkedPrefixTest, TestCaseInfo( "forked prefix", TestCaseInfo::ForkSections ) );
+  std::vector<ITestCase*> tests{ &test };
+  BufferedTestReport report;
+  TestRunResult runResult;
+  IsolatedRunner( theACatch(), 1, &report ).run( tests, runResult );
+
+  // a1, a2 and b check in their section and after it, a and the parent after the sections
+  ACATCH_REQUIRE( EXPECT, runResult.getFailedAssertionCount() == 0 );
+  ACATCH_REQUIRE( EXPECT, runResult.getPassedAssertionCount() == 8 );
+}
+
+ACATCH_TEST_CASE( "acatch.fork_sections.trailing" ) {
+  using namespace ACatch;
+  if( !SectionForker::isSupported() )
+    return; // the sections are replayed, the trailing code runs once per leaf
+
+  FunctionTestCase test( forkedTrailingTest, TestCaseInfo( "forked trailing", TestCaseInfo::ForkSections ) );
+  std::vector<ITestCase*> tests{ &test };
+  BufferedTestReport report;
+  TestRunResult runResult;
+  IsolatedRunner( theACatch(), 1, &report ).run( tests, runResult );
+
+  // the check after the sections passes in the children of a and b, and fails
+  // in the parent where no section ran (serially it would pass twice)
+  ACATCH_REQUIRE( EXPECT, runResult.getFailedAssertionCount() == 1 );
+  ACATCH_REQUIRE( EXPECT, runResult.getPassedAssertionCount() == 2 );
+}
+
+} // namespace ACatchTest
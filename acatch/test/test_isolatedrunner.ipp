@@ -0,0 +1,217 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 210000
+
+#include <chrono>
+#include <csignal>
+#include <map>
+#include <thread>
+
+namespace ACatchTest {
+
+namespace {
+
+/// Record the events, the logs and the end state of the test cases run by a runner
+class RecordingTestReport
+    : public ACatch::ITestReport
+{
+public:
+  std::map<std::string, std::vector<std::string>> events; ///< the events and messages of each test case, without the timings
+  std::vector<std::string> logs;       ///< all the reported messages
+  std::map<std::string, bool> aborted; ///< the ended test cases, true if the last run was aborted
+
+  virtual void setProperty( const std::string&, const std::string& ) override {}
+  virtual void reportTestCases( const ACatch::ConstTestCaseInfoRefs& ) override {}
+  virtual void reportShard( ACatch::uint, ACatch::uint, const ACatch::ConstTestCaseInfoRefs& ) override {}
+  virtual void reportTestCaseSkip( const ACatch::TestCaseInfo& ) override {}
+
+  virtual void reportTestCaseStart( const ACatch::TestCaseInfo& aInfo ) override {
+    mTestName = aInfo.name;
+    events[ mTestName ].push_back( "start" );
+  }
+
+  virtual void reportTestSectionStart( const ACatch::SectionInfo& aInfo ) override {
+    events[ mTestName ].push_back( "section " + aInfo.name );
+  }
+
+  virtual void reportTestSectionSkip( const ACatch::SectionInfo& aInfo ) override {
+    events[ mTestName ].push_back( "skip " + aInfo.name );
+  }
+
+  virtual void reportTestSectionEnd( const ACatch::SectionInfo& aInfo, ACatch::TestCaseResult& aResult, const ACatch::Timing& ) override {
+    events[ mTestName ].push_back( "section end " + aInfo.name + counts( aResult ) );
+    record( aResult );
+  }
+
+  virtual void reportTestCaseEnd( const ACatch::TestCaseInfo& aInfo, ACatch::TestCaseResult& aResult, const ACatch::Timing& ) override {
+    events[ mTestName ].push_back( "end" + counts( aResult ) );
+    record( aResult );
+    aborted[ aInfo.name ] = aResult.isAborting();
+  }
+
+  virtual void reportLogNow( ACatch::TestCaseResult& aResult ) override {
+    events[ mTestName ].push_back( "log now" );
+    record( aResult );
+  }
+
+  virtual void reportTestRun( const ACatch::ConstTestCaseInfoRefs&, ACatch::TestRunResult& ) override {}
+  virtual void reportAssertionSites( const std::vector<const ACatch::AssertionSite*>& ) override {}
+
+  /// Number of messages containing the text
+  size_t count( const char* aText ) const {
+    size_t n = 0;
+    for( const std::string& log : logs )
+      n += log.find( aText ) != std::string::npos;
+    return n;
+  }
+
+private:
+  std::string mTestName; ///< the running test case
+
+  static std::string counts( const ACatch::TestCaseResult& aResult ) {
+    return ": " + std::to_string( aResult.getSuccessCount() ) + " passed, " + std::to_string( aResult.getFailCount() )
+           + " failed";
+  }
+
+  void record( ACatch::TestCaseResult& aResult ) {
+    ACatch::TestCaseResult::Logs l;
+    aResult.takeLogs( l );
+    for( auto& log : l ) {
+      events[ mTestName ].push_back( log.second.str() );
+      logs.push_back( log.second.str() );
+    }
+  }
+};
+
+
+void crashingTest() {
+  ACATCH_SECTION( "before" ) {
+    ACATCH_REQUIRE( EXPECT, true );
+  }
+  ACATCH_SECTION( "crash" ) {
+    // the checks of the threads of the test case still reach the worker
+    std::thread t( [] { ACATCH_REQUIRE( EXPECT, true ); } );
+    t.join();
+    std::raise( SIGSEGV );
+  }
+}
+
+
+void passingTest() {
+  ACATCH_REQUIRE( EXPECT, 1 + 1 == 2 );
+}
+
+
+void hangingTest() {
+  ACATCH_SECTION( "fast" ) {
+    ACATCH_REQUIRE( EXPECT, true );
+  }
+  ACATCH_SECTION( "hang" ) {
+    for( int i = 0; i < 300; ++i )
+      std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+  }
+}
+
+
+void zygoteReportedTest() {
+  ACATCH_REQUIRE( EXPECT, true );
+  ACATCH_SECTION( "a" ) {
+    ACATCH_INFO( "entered a" );
+    ACATCH_REPORT_NOW;
+    ACATCH_SECTION( "a1" ) {
+      ACATCH_REQUIRE( EXPECT, true );
+    }
+    ACATCH_SECTION( "a2" ) {
+      ACATCH_REQUIRE_ALL( EXPECT, true, true );
+    }
+  }
+  ACATCH_SECTION( "b" ) {
+    ACATCH_INFO( "entered b" );
+  }
+}
+
+} // namespace
+
+ACATCH_TEST_CASE( "acatch.isolated_runner" ) {
+  using namespace ACatch;
+  if( !SectionForker::isSupported() )
+    return; // no process isolation, the crash would end the self test
+
+  FunctionTestCase crashing( crashingTest, TestCaseInfo( "crashing" ) );
+  FunctionTestCase passing( passingTest, TestCaseInfo( "passing" ) );
+  std::vector<ITestCase*> tests{ &crashing, &passing };
+  RecordingTestReport report;
+  TestRunResult runResult;
+  IsolatedRunner( theACatch(), 1, &report ).run( tests, runResult );
+
+  // the crash aborts its test case only, the next one runs in a new worker
+  ACATCH_REQUIRE( EXPECT, report.aborted.size() == 2 );
+  ACATCH_REQUIRE( EXPECT, report.aborted[ "crashing" ] );
+  ACATCH_REQUIRE( EXPECT, !report.aborted[ "passing" ] );
+  ACATCH_REQUIRE( EXPECT, runResult.getFailedTestCount() == 1 );
+
+  // the signal is reported once, by the worker, instead of its exit status
+  ACATCH_REQUIRE( EXPECT, report.count( "SIGSEGV" ) == 1 );
+  ACATCH_REQUIRE( EXPECT, report.count( "exited with code" ) == 0 );
+}
+
+ACATCH_TEST_CASE( "acatch.watchdog" ) {
+  using namespace ACatch;
+  if( !SectionForker::isSupported() )
+    return; // no process isolation, the timeout would end the self test
+
+  FunctionTestCase hanging( hangingTest, TestCaseInfo( "hanging", TestCaseInfo::None, 0.1 ) );
+  FunctionTestCase forked( hangingTest, TestCaseInfo( "hanging forked", TestCaseInfo::ForkSections, 0.1 ) );
+  std::vector<ITestCase*> tests{ &hanging, &forked };
+  RecordingTestReport report;
+  TestRunResult runResult;
+  IsolatedRunner( theACatch(), 1, &report ).run( tests, runResult );
+
+  // the worker reports the running section, also when it runs in a forked child
+  ACATCH_REQUIRE_ALL( EXPECT, report.aborted[ "hanging" ], report.aborted[ "hanging forked" ] );
+  ACATCH_REQUIRE( EXPECT, report.count( "timed out after 0.1 s in section: hanging.hang" ) == 1 );
+  ACATCH_REQUIRE( EXPECT, report.count( "timed out after 0.1 s in section: hanging forked.hang" ) == 1 );
+  ACATCH_REQUIRE( EXPECT, report.count( "process timed out" ) == 0 );
+}
+
+ACATCH_TEST_CASE( "acatch.zygote" ) {
+  using namespace ACatch;
+  if( !SectionForker::isSupported() )
+    return; // no fork, the runs share the process
+  if( dynamic_cast<BufferedTestReport*>( theACatch().context().getTestReport() ) )
+    return; // other runners share the process, the child could inherit the locks they hold
+  if( theACatch().context().isForkingSections() )
+    return; // the forked sections are reported in fewer cycles than the serial ones
+
+  FunctionTestCase reported( zygoteReportedTest, TestCaseInfo( "zygote reported" ) );
+  FunctionTestCase passing( passingTest, TestCaseInfo( "passing" ) );
+  std::vector<ITestCase*> tests{ &reported, &passing };
+
+  RecordingTestReport serialReport;
+  TestRunResult serialResult;
+  {
+    RunContext ctx( &serialReport, false );
+    for( ITestCase* tc : tests )
+      theACatch().runTest( ctx, *tc, serialResult );
+  }
+
+  // the child reports the same events as a serial run, and the same results.
+  // Its test cases may end in another order when it runs them concurrently.
+  RecordingTestReport zygoteReport;
+  TestRunResult zygoteResult;
+  Zygote( theACatch(), &zygoteReport ).run( tests, zygoteResult );
+  ACATCH_REQUIRE( EXPECT, zygoteReport.events == serialReport.events );
+  ACATCH_REQUIRE_ALL( EXPECT, zygoteResult.getPassedTestCount() == serialResult.getPassedTestCount(),
+                      zygoteResult.getFailedTestCount() == serialResult.getFailedTestCount(),
+                      zygoteResult.getPassedAssertionCount() == serialResult.getPassedAssertionCount(),
+                      zygoteResult.getFailedAssertionCount() == 0 );
+}
+
+} // namespace ACatchTest
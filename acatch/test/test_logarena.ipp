@@ -0,0 +1,58 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 130000
+
+namespace ACatchTest {
+
+ACATCH_TEST_CASE( "acatch.log_arena" ) {
+  using namespace ACatch;
+
+  LogArena arena;
+
+  ACATCH_SECTION( "copy" ) {
+    StringRef a = arena.copy( std::string( "first" ) );
+    StringRef b = arena.copy( "second" );
+    ACATCH_REQUIRE( EXPECT, a.str() == "first" );
+    ACATCH_REQUIRE( EXPECT, b.str() == "second" );
+    ACATCH_REQUIRE( EXPECT, reinterpret_cast<uintptr_t>( b.data() ) % alignof( std::max_align_t ) == 0 );
+    ACATCH_REQUIRE( EXPECT, arena.getBlockCount() == 1 );
+  }
+
+  ACATCH_SECTION( "reuse after reset" ) {
+    for( int i = 0; i < 1000; ++i )
+      arena.allocate( 100 );
+    size_t blocks = arena.getBlockCount();
+    ACATCH_REQUIRE( EXPECT, blocks > 1 );
+    arena.reset();
+    for( int i = 0; i < 1000; ++i )
+      arena.allocate( 100 );
+    ACATCH_REQUIRE( EXPECT, arena.getBlockCount() == blocks );
+  }
+
+  ACATCH_SECTION( "large allocation" ) {
+    std::string large( 1000000, 'x' );
+    StringRef ref = arena.copy( large );
+    ACATCH_REQUIRE( EXPECT, ref.size() == large.size() );
+    ACATCH_REQUIRE( EXPECT, ref.str() == large );
+  }
+
+  ACATCH_SECTION( "result logs" ) {
+    TestCaseResult result( &arena );
+    std::string message = "message";
+    result.logMessage( TestCaseResult::Info, message );
+    message = "changed";
+    TestCaseResult::Logs logs;
+    result.takeLogs( logs );
+    ACATCH_REQUIRE( EXPECT, logs.size() == 1 );
+    ACATCH_REQUIRE( EXPECT, logs[ 0 ].second.str() == "message" );
+  }
+}
+
+} // namespace ACatchTest
@@ -0,0 +1,111 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 150000
+
+namespace ACatchTest {
+
+ACATCH_TEST_CASE( "acatch.log_retention" ) {
+  using namespace ACatch;
+
+  LogArena arena;
+  TestCaseResult result( &arena );
+  TestCaseResult::Logs logs;
+
+  ACATCH_SECTION( "repeats collapsed" ) {
+    result.logMessage( TestCaseResult::Info, "a" );
+    for( int i = 0; i < 5; ++i )
+      result.logMessage( TestCaseResult::Info, "b" );
+    result.logMessage( TestCaseResult::Info, "a" );
+    result.takeLogs( logs );
+    ACATCH_REQUIRE( ASSERT, logs.size() == 4 );
+    ACATCH_REQUIRE( EXPECT, logs[ 1 ].second.str() == "b" );
+    ACATCH_REQUIRE( EXPECT, logs[ 2 ].second.str() == "previous message repeated 4 more times" );
+    ACATCH_REQUIRE( EXPECT, logs[ 3 ].second.str() == "a" );
+  }
+
+  ACATCH_SECTION( "first and last kept" ) {
+    result.setRetention( 3, 2 );
+    for( int i = 0; i < 10; ++i )
+      result.logMessage( TestCaseResult::Info, std::to_string( i ) );
+    result.takeLogs( logs );
+    ACATCH_REQUIRE( ASSERT, logs.size() == 6 );
+    ACATCH_REQUIRE( EXPECT, logs[ 2 ].second.str() == "2" );
+    ACATCH_REQUIRE( EXPECT, logs[ 3 ].first == TestCaseResult::Warning );
+    ACATCH_REQUIRE( EXPECT, logs[ 3 ].second.str() == "5 messages dropped" );
+    ACATCH_REQUIRE( EXPECT, logs[ 4 ].second.str() == "8" );
+    ACATCH_REQUIRE( EXPECT, logs[ 5 ].second.str() == "9" );
+
+    // the next drain starts a new head
+    result.logMessage( TestCaseResult::Info, "next" );
+    result.takeLogs( logs );
+    ACATCH_REQUIRE( ASSERT, logs.size() == 1 );
+    ACATCH_REQUIRE( EXPECT, logs[ 0 ].second.str() == "next" );
+  }
+
+  ACATCH_SECTION( "single message dropped" ) {
+    result.setRetention( 1, 1 );
+    for( int i = 0; i < 3; ++i )
+      result.logMessage( TestCaseResult::Info, std::to_string( i ) );
+    result.takeLogs( logs );
+    ACATCH_REQUIRE( ASSERT, logs.size() == 3 );
+    ACATCH_REQUIRE( EXPECT, logs[ 1 ].second.str() == "1 message dropped" );
+
+    result.logMessage( TestCaseResult::Info, "a" );
+    result.logMessage( TestCaseResult::Info, "a" );
+    result.takeLogs( logs );
+    ACATCH_REQUIRE( ASSERT, logs.size() == 2 );
+    ACATCH_REQUIRE( EXPECT, logs[ 1 ].second.str() == "previous message repeated 1 more time" );
+  }
+
+  ACATCH_SECTION( "retained logs moved as they are" ) {
+    // the results of the workers and of the buffered reports keep the drained
+    // logs of their source, without retaining or collapsing them again
+    result.setRetention( 3, 2 );
+    for( int i = 0; i < 10; ++i )
+      result.logMessage( TestCaseResult::Info, std::to_string( i ) );
+
+    BufferedTestReport buffered;
+    buffered.reportLogNow( result );
+    TestCaseResult target;
+    target.setRetention( 1, 0 );
+    target.logMessage( TestCaseResult::Info, "0" );
+    struct LogsReport : BufferedTestReport {
+      TestCaseResult* target;
+      virtual void reportLogNow( TestCaseResult& aResult ) override {
+        target->merge( aResult );
+      }
+    } report;
+    report.target = &target;
+    buffered.flushTo( report );
+
+    target.takeLogs( logs );
+    ACATCH_REQUIRE( ASSERT, logs.size() == 7 );
+    ACATCH_REQUIRE( EXPECT, logs[ 1 ].second.str() == "0" );
+    ACATCH_REQUIRE( EXPECT, logs[ 3 ].second.str() == "2" );
+    ACATCH_REQUIRE( EXPECT, logs[ 4 ].second.str() == "5 messages dropped" );
+    ACATCH_REQUIRE( EXPECT, logs[ 6 ].second.str() == "9" );
+  }
+
+  ACATCH_SECTION( "memory bounded" ) {
+    result.setRetention( 10, 10 );
+    for( int i = 0; i < 100; ++i )
+      result.logMessage( TestCaseResult::Info, std::to_string( i ) );
+    size_t blocks = arena.getBlockCount();
+    for( int i = 0; i < 100000; ++i )
+      result.logMessage( TestCaseResult::Info, std::to_string( i ) );
+    ACATCH_REQUIRE( EXPECT, arena.getBlockCount() == blocks );
+    result.takeLogs( logs );
+    ACATCH_REQUIRE( ASSERT, logs.size() == 21 );
+    ACATCH_REQUIRE( EXPECT, logs[ 10 ].second.str() == "100080 messages dropped" );
+    ACATCH_REQUIRE( EXPECT, logs[ 20 ].second.str() == "99999" );
+  }
+}
+
+} // namespace ACatchTest
@@ -0,0 +1,61 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 80000
+
+namespace ACatchTest {
+
+ACATCH_TEST_CASE( "acatch.parallel_sections", ACatch::TestCaseInfo::ParallelSections ) {
+  using namespace ACatch;
+
+  // executed once for each leaf, each path has its own copy
+  std::vector<int> data( 3, 1 );
+
+  ACATCH_SECTION( "s1" ) {
+    data[ 0 ] = 2;
+    ACATCH_SECTION( "s1.1" ) {
+      ACATCH_REQUIRE_ALL( EXPECT, data[ 0 ] == 2, data[ 1 ] == 1, data[ 2 ] == 1 );
+    }
+    ACATCH_SECTION( "s1.2" ) {
+      data[ 1 ] = 3;
+      ACATCH_REQUIRE_ALL( EXPECT, data[ 0 ] == 2, data[ 1 ] == 3, data[ 2 ] == 1 );
+    }
+  }
+
+  ACATCH_SECTION( "s2" ) {
+    data[ 1 ] = 2;
+    ACATCH_REQUIRE_ALL( EXPECT, data[ 0 ] == 1, data[ 1 ] == 2, data[ 2 ] == 1 );
+  }
+
+  ACATCH_SECTION( "s3" ) {
+    ACATCH_SECTION( "s3.1" ) {
+      data[ 2 ] = 4;
+      ACATCH_REQUIRE_ALL( EXPECT, data[ 0 ] == 1, data[ 1 ] == 1, data[ 2 ] == 4 );
+    }
+    ACATCH_SECTION( "s3.2" ) {
+      ACATCH_REQUIRE_ALL( EXPECT, data[ 0 ] == 1, data[ 1 ] == 1, data[ 2 ] == 1 );
+    }
+  }
+
+  ACATCH_SECTION( "s30" ) {
+    ACATCH_REQUIRE_ALL( EXPECT, data[ 0 ] == 1, data[ 1 ] == 1, data[ 2 ] == 1 );
+  }
+
+  // a name with a dot is not a path: the run of "p" does not enter "p.q" and
+  // the run of "p.q" does not enter "p"
+  int dottedRuns = 0;
+  ACATCH_SECTION( "p" ) {
+    ACATCH_REQUIRE( EXPECT, ++dottedRuns == 1 );
+  }
+  ACATCH_SECTION( "p.q" ) {
+    ACATCH_REQUIRE( EXPECT, ++dottedRuns == 1 );
+  }
+}
+
+} // namespace ACatchTest
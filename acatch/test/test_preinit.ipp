@@ -0,0 +1,46 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 100000
+
+namespace ACatchTest {
+
+namespace {
+std::atomic<int> preinitConfig( 0 );
+std::atomic<int> preinitData( 0 );
+std::atomic<int> preinitUnused( 0 );
+std::atomic<int> preinitUnnamed( 0 );
+} // namespace
+
+ACATCH_PREINIT() {
+  // executed before the named ones it does not depend on
+  preinitUnnamed = preinitData + 1;
+}
+
+ACATCH_PREINIT( "acatch.preinit.data", "acatch.preinit.config" ) {
+  // executed once the config is done
+  preinitData = preinitConfig + 1;
+}
+
+ACATCH_PREINIT( "acatch.preinit.config" ) {
+  preinitConfig = 1;
+}
+
+ACATCH_PREINIT( "acatch.preinit.unused" ) {
+  preinitUnused = 1;
+}
+
+ACATCH_TEST_CASE( "acatch.preinit", ACatch::TestCaseInfo::None, 0, "acatch.preinit.data" ) {
+  ACATCH_REQUIRE( EXPECT, preinitConfig == 1 );
+  ACATCH_REQUIRE( EXPECT, preinitData == 2 );
+  ACATCH_REQUIRE( EXPECT, preinitUnused == 0 );
+  ACATCH_REQUIRE( EXPECT, preinitUnnamed == 1 );
+}
+
+} // namespace ACatchTest
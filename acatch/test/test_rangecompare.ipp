@@ -0,0 +1,64 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 160000
+
+namespace ACatchTest {
+
+ACATCH_TEST_CASE( "acatch.range_compare" ) {
+  using namespace ACatch;
+
+  std::vector<int> a( 10000 );
+  for( size_t i = 0; i < a.size(); ++i )
+    a[ i ] = static_cast<int>( i );
+  std::vector<int> b = a;
+
+  ACATCH_SECTION( "equal" ) {
+    ACATCH_REQUIRE_RANGE_EQ( EXPECT, a, b );
+    int c[] = { 1, 2, 3 };
+    std::vector<int> d = { 1, 2, 3 };
+    ACATCH_REQUIRE_RANGE_EQ( EXPECT, c, d );
+  }
+
+  ACATCH_SECTION( "first mismatches" ) {
+    for( size_t i = 5000; i < 5010; ++i )
+      b[ i ] = -1;
+    b[ 1 ] = -1;
+    auto cmp = rangeEq( a, b );
+    ACATCH_REQUIRE( ASSERT, !cmp );
+    ACATCH_REQUIRE( EXPECT, cmp.getMismatchCount() == 11 );
+    std::string report = toString( cmp );
+    ACATCH_REQUIRE( EXPECT, startsWith( report, "11 mismatches in 10000 elements" ) );
+    ACATCH_REQUIRE( EXPECT, report.find( "\n  [1] { 0, >1<, 2, 3, ... } != { 0, >-1<, 2, 3, ... }" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, report.find( "[5003]" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, report.find( "[5004]" ) == std::string::npos );
+    ACATCH_REQUIRE( EXPECT, report.find( "... 6 more mismatches" ) != std::string::npos );
+  }
+
+  ACATCH_SECTION( "sizes differ" ) {
+    b.pop_back();
+    auto cmp = rangeEq( a, b );
+    ACATCH_REQUIRE( EXPECT, !cmp );
+    ACATCH_REQUIRE( EXPECT, cmp.getMismatchCount() == 0 );
+    ACATCH_REQUIRE( EXPECT, toString( cmp ).find( "sizes differ: 10000 != 9999" ) != std::string::npos );
+  }
+
+  ACATCH_SECTION( "near" ) {
+    std::vector<double> x( 1000, 1.0 );
+    std::vector<double> y( 1000, 1.0005 );
+    ACATCH_REQUIRE_RANGE_NEAR( EXPECT, x, y, 0.001 );
+    y[ 999 ] = std::numeric_limits<double>::quiet_NaN();
+    auto cmp = rangeNear( x, y, 0.001 );
+    ACATCH_REQUIRE( EXPECT, !cmp );
+    ACATCH_REQUIRE( EXPECT, cmp.getMismatchCount() == 1 );
+    ACATCH_REQUIRE( EXPECT, toString( cmp ).find( "with tolerance 0.001" ) != std::string::npos );
+  }
+}
+
+} // namespace ACatchTest
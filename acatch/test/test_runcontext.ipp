@@ -0,0 +1,70 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 70000
+
+#include <thread>
+
+namespace ACatchTest {
+
+ACATCH_TEST_CASE( "acatch.run_context" ) {
+  using namespace ACatch;
+
+  ACATCH_SECTION( "adopt context" ) {
+    RunContext* ctx = &theACatch().context();
+    bool running = false;
+    std::thread t( [ctx, &running] {
+      RunContextScope scope( ctx );
+      running = theACatch().isRunning();
+      ACATCH_REQUIRE( EXPECT, &theACatch().context() == ctx );
+    } );
+    t.join();
+    ACATCH_REQUIRE( EXPECT, running );
+    ACATCH_REQUIRE( EXPECT, &theACatch().context() == ctx );
+  }
+
+  ACATCH_SECTION( "restore context" ) {
+    RunContext* ctx = &theACatch().context();
+    RunContext other( ctx->getTestReport() );
+    bool running = true;
+    {
+      RunContextScope scope( &other );
+      running = theACatch().isRunning();
+    }
+    ACATCH_REQUIRE( EXPECT, running == false );
+    ACATCH_REQUIRE( EXPECT, &theACatch().context() == ctx );
+  }
+
+  ACATCH_SECTION( "inherit context" ) {
+    RunContext* ctx = &theACatch().context();
+    RunContext* inherited = nullptr;
+    std::thread t( inheritContext( [&inherited] {
+      inherited = &theACatch().context();
+      ACATCH_REQUIRE( ASSERT, theACatch().isRunning() );
+    } ) );
+    t.join();
+    ACATCH_REQUIRE( EXPECT, inherited == ctx );
+  }
+
+  ACATCH_SECTION( "unbound thread" ) {
+    // falls back to the running test case, or under --jobs to the checks of
+    // the unbound threads, never to a context without a result
+    bool running = false;
+    std::thread t( [&running] {
+      running = theACatch().isRunning();
+      for( int i = 0; i < 100; ++i )
+        ACATCH_REQUIRE( EXPECT, i >= 0 );
+      ACATCH_INFO( "logged from an unbound thread" );
+    } );
+    t.join();
+    ACATCH_REQUIRE( EXPECT, running );
+  }
+}
+
+} // namespace ACatchTest
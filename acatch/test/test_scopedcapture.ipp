@@ -0,0 +1,49 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 140000
+
+namespace ACatchTest {
+
+ACATCH_TEST_CASE( "acatch.scoped_capture" ) {
+  using namespace ACatch;
+
+  ACATCH_SECTION( "formatted on demand" ) {
+    int value = 1;
+    ACATCH_CAPTURE( value );
+    value = 2;
+    std::vector<std::string> captures = ScopedCapture::formatActive();
+    ACATCH_REQUIRE( EXPECT, captures.size() == 1 );
+    ACATCH_REQUIRE( EXPECT, captures[ 0 ] == "\"value\" = 2" );
+  }
+
+  ACATCH_SECTION( "scoped" ) {
+    int outer = 1;
+    ACATCH_CAPTURE( outer );
+    for( int i = 0; i < 3; ++i ) {
+      ACATCH_CAPTURE( i * 10 );
+      ACATCH_REQUIRE( EXPECT, ScopedCapture::formatActive().size() == 2 );
+      ACATCH_REQUIRE( EXPECT, ScopedCapture::formatActive()[ 1 ] == "\"i * 10\" = " + std::to_string( i * 10 ) );
+    }
+    ACATCH_REQUIRE( EXPECT, ScopedCapture::formatActive().size() == 1 );
+  }
+
+  ACATCH_SECTION( "per thread" ) {
+    int value = 1;
+    ACATCH_CAPTURE( value );
+    size_t threadCaptures = 1;
+    std::thread t( [&threadCaptures] { threadCaptures = ScopedCapture::formatActive().size(); } );
+    t.join();
+    ACATCH_REQUIRE( EXPECT, threadCaptures == 0 );
+  }
+
+  ACATCH_REQUIRE( EXPECT, ScopedCapture::formatActive().empty() );
+}
+
+} // namespace ACatchTest
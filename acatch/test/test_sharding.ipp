@@ -0,0 +1,94 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 220000
+
+#include <set>
+
+namespace ACatchTest {
+
+namespace {
+
+void emptyTest() {
+}
+
+
+void registerTests( ACatch::TestRegistry& aRegistry, size_t aCount ) {
+  for( size_t i = 0; i < aCount; ++i ) {
+    std::string name = "test" + std::to_string( i );
+    aRegistry.registerTest( new ACatch::FunctionTestCase( emptyTest, ACatch::TestCaseInfo( name.c_str() ) ) );
+  }
+}
+
+
+std::vector<std::string> testNames( const std::vector<ACatch::ITestCase*>& aTests ) {
+  std::vector<std::string> names;
+  for( const ACatch::ITestCase* tc : aTests )
+    names.push_back( tc->testInfo().name );
+  return names;
+}
+
+} // namespace
+
+ACATCH_TEST_CASE( "acatch.sharding" ) {
+  using namespace ACatch;
+  typedef TestRegistry::RunOrder RunOrder;
+
+  const size_t testCount = 40;
+  const uint shardCount = 3;
+  TestRegistry registry;
+  registerTests( registry, testCount );
+
+  // the history of another machine, with different durations
+  TestRegistry other;
+  registerTests( other, testCount );
+  for( size_t i = 0; i < testCount; i += 2 ) {
+    registry.getDurationHistory().setDuration( "test" + std::to_string( i ), 1. + i );
+    other.getDurationHistory().setDuration( "test" + std::to_string( i ), 100. - i );
+  }
+
+  ACATCH_SECTION( "membership" ) {
+    // the shards split the test cases whatever the history of each machine
+    std::set<std::string> all;
+    size_t total = 0;
+    for( uint shard = 0; shard < shardCount; ++shard ) {
+      std::vector<std::string> names = testNames( registry.getShardTests( RunOrder::InDurationHistoryOrder, shard, shardCount ) );
+      std::vector<std::string> otherNames = testNames( other.getShardTests( RunOrder::InLexicographicalOrder, shard, shardCount ) );
+      ACATCH_REQUIRE( EXPECT, !names.empty() );
+      ACATCH_REQUIRE( EXPECT, std::set<std::string>( names.begin(), names.end() )
+                              == std::set<std::string>( otherNames.begin(), otherNames.end() ) );
+      all.insert( names.begin(), names.end() );
+      total += names.size();
+    }
+    ACATCH_REQUIRE_ALL( EXPECT, all.size() == testCount, total == testCount );
+  }
+
+  ACATCH_SECTION( "order" ) {
+    // in a shard the test cases with a history run longest first, then the others by name
+    for( uint shard = 0; shard < shardCount; ++shard ) {
+      std::vector<ITestCase*> tests = registry.getShardTests( RunOrder::InDurationHistoryOrder, shard, shardCount );
+      bool timed = true;
+      double previous = 0;
+      for( size_t i = 0; i < tests.size(); ++i ) {
+        double duration = 0;
+        bool hasDuration = registry.getDurationHistory().getDuration( tests[ i ]->testInfo().name, duration );
+        bool grouped = timed || !hasDuration;
+        ACATCH_REQUIRE( EXPECT, grouped );
+        if( hasDuration && i > 0 )
+          ACATCH_REQUIRE( EXPECT, duration <= previous );
+        if( !hasDuration && !timed )
+          ACATCH_REQUIRE( EXPECT, tests[ i - 1 ]->testInfo().name < tests[ i ]->testInfo().name );
+        timed = hasDuration;
+        previous = duration;
+      }
+    }
+  }
+}
+
+} // namespace ACatchTest
@@ -0,0 +1,68 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 200000
+
+namespace ACatchTest {
+
+template <typename L, typename R>
+std::string expandStrings( const L& aLhs, const R& aRhs ) {
+  ACatch::ExpressionCapture capture( "lhs == rhs" );
+  ( ( ACatch::ExpressionDecomposer() <= aLhs ) == aRhs ).expand( capture );
+  return capture.getExpandedString();
+}
+
+ACATCH_TEST_CASE( "acatch.string_diff" ) {
+  using namespace ACatch;
+
+  std::string text;
+  for( int i = 1; i <= 10000; ++i )
+    text += "line " + std::to_string( i ) + "\n";
+  std::string other = text;
+
+  ACATCH_SECTION( "short strings in full" ) {
+    ACATCH_REQUIRE( EXPECT, expandStrings( std::string( "abc" ), "abd" ) == "\"abc\" \"==\" \"abd\"" );
+    const char* null = nullptr;
+    ACATCH_REQUIRE( EXPECT, startsWith( expandStrings( text, null ), "\"line 1\\nline 2" ) );
+  }
+
+  ACATCH_SECTION( "changed lines" ) {
+    other.replace( other.find( "line 500\n" ), 8, "line 5000" );
+    other.erase( other.find( "line 9000\n" ), 10 );
+    std::string diff = expandStrings( text, other );
+    ACATCH_REQUIRE( EXPECT, startsWith( diff, "{ 98894 bytes, 10001 lines } \"==\" { 98885 bytes, 10000 lines }" ) );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  first difference at line 500, column 9\n  @@ -497,7 +497,7 @@\n    \"line 497\"" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  - \"line 500><\"\n  + \"line 500>0<\"" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  @@ -8997,7 +8997,6 @@" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n    \"line 8999\"\n  - \"line 9000\"\n    \"line 9001\"" ) != std::string::npos );
+  }
+
+  ACATCH_SECTION( "long line" ) {
+    std::string line( 100000, 'a' );
+    std::string changed = line;
+    changed[ 50000 ] = '\t';
+    std::string diff = expandStrings( line, changed );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  + ...\"aaaaaaaaaaaaaaaaaaaa>\\t<aaaaaaaaaaaaaaaaaaaa\"..." ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, diff.size() < 300 );
+  }
+
+  ACATCH_SECTION( "budget exceeded" ) {
+    std::string lhs;
+    std::string rhs;
+    for( int i = 0; i < 3000; ++i ) {
+      lhs += "x" + std::to_string( i ) + "\n";
+      rhs += "y" + std::to_string( i ) + "\n";
+    }
+    std::string diff = expandStrings( "head\n" + lhs + "tail\n", "head\n" + rhs + "tail\n" );
+    ACATCH_REQUIRE( EXPECT, diff.find( "too many changes to diff, the range differing is shown\n  @@ -1,3003 +1,3003 @@" ) != std::string::npos );
+    ACATCH_REQUIRE( EXPECT, diff.find( "\n  - ... 2992 more lines" ) != std::string::npos );
+  }
+}
+
+} // namespace ACatchTest
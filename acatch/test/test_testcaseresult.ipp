@@ -0,0 +1,123 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 230000
+
+#include <thread>
+
+namespace ACatchTest {
+
+namespace {
+
+// each thread counts in a producer of its own
+const size_t threadCount = 20;
+const size_t successCount = 100000;
+
+void concurrentChecksTest() {
+  std::vector<std::thread> checkers;
+  for( size_t i = 0; i < threadCount; ++i ) {
+    checkers.emplace_back( ACatch::inheritContext( [] {
+      for( size_t j = 0; j < successCount; ++j )
+        ACATCH_REQUIRE( EXPECT, j < successCount );
+    } ) );
+  }
+  for( auto& t : checkers )
+    t.join();
+}
+
+} // namespace
+
+ACATCH_TEST_CASE( "acatch.test_case_result" ) {
+  using namespace ACatch;
+
+  TestCaseResult result;
+
+  ACATCH_SECTION( "concurrent successes" ) {
+    std::atomic<bool> done( false );
+    bool monotonic = true;
+    std::thread reader( [&] {
+      uint64_t previous = 0;
+      while( !done.load() ) {
+        uint64_t count = result.getSuccessCount();
+        monotonic = monotonic && count >= previous;
+        previous = count;
+      }
+    } );
+
+    std::vector<std::thread> writers;
+    for( size_t i = 0; i < threadCount; ++i ) {
+      writers.emplace_back( [&] {
+        for( size_t j = 0; j < successCount; ++j )
+          result.logSuccess();
+      } );
+    }
+    for( auto& t : writers )
+      t.join();
+    done = true;
+    reader.join();
+
+    ACATCH_REQUIRE( EXPECT, monotonic );
+    ACATCH_REQUIRE( EXPECT, result.getSuccessCount() == threadCount * successCount );
+    ACATCH_REQUIRE( EXPECT, !result.isFailed() );
+  }
+
+  ACATCH_SECTION( "concurrent logs" ) {
+    // the threads log while the reporter drains, no message is lost or reordered
+    const size_t messageCount = 5000;
+    result.setRetention( messageCount, 0 );
+    std::atomic<bool> done( false );
+    TestCaseResult::Logs logs;
+    std::thread reader( [&] {
+      TestCaseResult::Logs taken;
+      while( !done.load() ) {
+        result.takeLogs( taken );
+        logs.insert( logs.end(), taken.begin(), taken.end() );
+      }
+    } );
+
+    std::vector<std::thread> writers;
+    for( size_t i = 0; i < threadCount; ++i ) {
+      writers.emplace_back( [&result, i, messageCount] {
+        for( size_t j = 0; j < messageCount; ++j )
+          result.logMessage( TestCaseResult::Info, std::to_string( i ) + ":" + std::to_string( j ) );
+      } );
+    }
+    for( auto& t : writers )
+      t.join();
+    done = true;
+    reader.join();
+    TestCaseResult::Logs taken;
+    result.takeLogs( taken );
+    logs.insert( logs.end(), taken.begin(), taken.end() );
+
+    std::vector<size_t> next( threadCount, 0 );
+    bool ordered = true;
+    for( auto& log : logs ) {
+      std::string message = log.second.str();
+      size_t colon = message.find( ':' );
+      size_t thread = std::stoul( message.substr( 0, colon ) );
+      ordered = ordered && std::stoul( message.substr( colon + 1 ) ) == next[ thread ]++;
+    }
+    ACATCH_REQUIRE( EXPECT, ordered );
+    ACATCH_REQUIRE( EXPECT, logs.size() == threadCount * messageCount );
+  }
+
+  ACATCH_SECTION( "concurrent checks" ) {
+    // the checks of the threads bound to a test case, through the macros
+    FunctionTestCase test( concurrentChecksTest, TestCaseInfo( "concurrent checks" ) );
+    std::vector<ITestCase*> tests{ &test };
+    BufferedTestReport report;
+    TestRunResult runResult;
+    IsolatedRunner( theACatch(), 1, &report ).run( tests, runResult );
+    ACATCH_REQUIRE( EXPECT, runResult.getPassedAssertionCount() == threadCount * successCount );
+    ACATCH_REQUIRE( EXPECT, runResult.getFailedAssertionCount() == 0 );
+  }
+}
+
+} // namespace ACatchTest
@@ -0,0 +1,49 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+// to avoid registration name conflicts due to includes
+#line 180000
+
+namespace ACatchTest {
+
+ACATCH_TEST_CASE( "acatch.toString_string" ) {
+  using namespace ACatch;
+
+  ACATCH_SECTION( "escaping" ) {
+    ACATCH_REQUIRE( EXPECT, toString( std::string( "plain" ) ) == "\"plain\"" );
+    ACATCH_REQUIRE( EXPECT, toString( std::string( "a\nb\tc\r" ) ) == "\"a\\nb\\tc\\r\"" );
+    ACATCH_REQUIRE( EXPECT, toString( std::string( "\x01\x1f\x7f\xe9", 4 ) ) == "\"\\x01\\x1f\\x7f\xe9\"" );
+    ACATCH_REQUIRE( EXPECT, toString( std::string( "z\0z", 3 ) ) == "\"z\\x00z\"" );
+    // the controls after the first 16 bytes block
+    std::string s( 40, 'x' );
+    s[ 17 ] = '\n';
+    s[ 39 ] = '\t';
+    ACATCH_REQUIRE( EXPECT, toString( s ) == "\"" + std::string( 17, 'x' ) + "\\n" + std::string( 21, 'x' ) + "\\t\"" );
+  }
+
+  ACATCH_SECTION( "elided" ) {
+    std::string s = std::string( 5000, 'a' ) + std::string( 5000, 'b' );
+    std::string rendered = toString( s );
+    size_t half = getMaxStringLength() / 2;
+    ACATCH_REQUIRE( EXPECT, rendered == "\"" + std::string( half, 'a' ) + "\"...\"" + std::string( half, 'b' )
+                                          + "\" (" + std::to_string( s.size() - 2 * half ) + " of 10000 bytes elided)" );
+  }
+
+  ACATCH_SECTION( "replaceInPlace" ) {
+    std::string s = "abcabc";
+    ACATCH_REQUIRE( EXPECT, replaceInPlace( s, "b", "bb" ) );
+    ACATCH_REQUIRE( EXPECT, s == "abbcabbc" );
+    ACATCH_REQUIRE( EXPECT, replaceInPlace( s, "bb", "" ) );
+    ACATCH_REQUIRE( EXPECT, s == "acac" );
+    ACATCH_REQUIRE( EXPECT, !replaceInPlace( s, "", "x" ) );
+    ACATCH_REQUIRE( EXPECT, !replaceInPlace( s, "z", "x" ) );
+    ACATCH_REQUIRE( EXPECT, s == "acac" );
+  }
+}
+
+} // namespace ACatchTest
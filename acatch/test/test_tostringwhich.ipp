@@ -14,6 +14,7 @@ namespace ACatch {
 struct has_toString {};
 struct has_maker {};
 struct has_maker_and_toString {};
+struct has_maker_append {};
 
 inline std::string toString( const has_toString& ) {
   return "toString( has_toString )";
@@ -36,6 +37,17 @@ struct StringMaker<has_maker_and_toString> {
     return "StringMaker<has_maker_and_toString>";
   }
 };
+
+template <>
+struct StringMaker<has_maker_append> {
+  static std::string convert( const has_maker_append& ) {
+    return "convert";
+  }
+
+  static void append( StringSink& aSink, const has_maker_append& ) {
+    aSink << "append";
+  }
+};
 } // namespace ACatch
 
 namespace ACatchTest {
@@ -86,6 +98,13 @@ ACATCH_TEST_CASE( "acatch.toString_which" ) {
     ACATCH_REQUIRE( EXPECT, toString( v ) == "{ StringMaker<has_maker>, StringMaker<has_maker> }" );
   }
 
+  // The sink protocol is preferred
+  ACATCH_SECTION( "toString( vectors<has_maker_append> )" ) {
+    std::vector<has_maker_append> v( 2 );
+    ACATCH_REQUIRE( EXPECT, toString( has_maker_append() ) == "append" );
+    ACATCH_REQUIRE( EXPECT, toString( v ) == "{ append, append }" );
+  }
+
   ACATCH_SECTION( "toString( vectors<has_maker_and_toString>(2) )" ) {
     std::vector<has_maker_and_toString> v( 2 );
     ACATCH_REQUIRE_ANY( EXPECT,
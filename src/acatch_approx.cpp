@@ -0,0 +1,212 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+#include <iomanip>
+
+namespace ACatch {
+
+namespace {
+
+template <typename T>
+struct FloatBits;
+
+template <>
+struct FloatBits<float> {
+  typedef int32_t Int;
+  typedef uint32_t UInt;
+};
+
+template <>
+struct FloatBits<double> {
+  typedef int64_t Int;
+  typedef uint64_t UInt;
+};
+
+/// The bits of a value as an integer ordered like the values: consecutive
+/// representable values have consecutive keys, -0.0 and 0.0 have the same key
+template <typename T>
+typename FloatBits<T>::Int orderedBits( T aValue ) {
+  typedef typename FloatBits<T>::Int Int;
+  Int bits;
+  std::memcpy( &bits, &aValue, sizeof( bits ) );
+  return bits < 0 ? std::numeric_limits<Int>::min() - bits : bits;
+}
+
+template <typename T>
+uint64_t ulpDistance( T aLhs, T aRhs ) {
+  typedef typename FloatBits<T>::UInt UInt;
+  typename FloatBits<T>::Int lhs = orderedBits( aLhs );
+  typename FloatBits<T>::Int rhs = orderedBits( aRhs );
+  return lhs < rhs ? UInt( rhs ) - UInt( lhs ) : UInt( lhs ) - UInt( rhs );
+}
+
+/// Per element check, written without branches so the range kernels are
+/// vectorized. Returns the absolute error, infinite for NaN and 0 for equal
+/// values, and sets aOk.
+template <typename T, bool UseUlps>
+T checkElement( T aLhs, T aRhs, T aEpsilon, T aMargin, uint64_t aUlps, bool& aOk ) {
+  T diff = std::fabs( aLhs - aRhs );
+  T scale = std::max( std::fabs( aLhs ), std::fabs( aRhs ) );
+  bool equal = aLhs == aRhs;
+  bool ok = equal | ( diff <= aMargin ) | ( diff <= aEpsilon * scale );
+  if( UseUlps )
+    ok = ok | ( ( ulpDistance( aLhs, aRhs ) <= aUlps ) & ( aLhs == aLhs ) & ( aRhs == aRhs ) );
+  aOk = ok;
+  T error = diff == diff ? diff : std::numeric_limits<T>::infinity();
+  return equal ? T( 0 ) : error;
+}
+
+/// Index of the first element out of tolerance in a block holding one
+template <typename T, bool UseUlps>
+size_t findFirst( const T* aLhs, const T* aRhs, size_t aBegin, size_t aEnd, T aEpsilon, T aMargin, uint64_t aUlps ) {
+  for( size_t i = aBegin; i < aEnd; ++i ) {
+    bool ok;
+    checkElement<T, UseUlps>( aLhs[ i ], aRhs[ i ], aEpsilon, aMargin, aUlps, ok );
+    if( !ok )
+      return i;
+  }
+  return aEnd;
+}
+
+/// Index of the first element of a block with the error of the given bits
+template <typename T, bool UseUlps>
+size_t findError( const T* aLhs, const T* aRhs, size_t aBegin, size_t aEnd, T aEpsilon, T aMargin, uint64_t aUlps,
+                  typename FloatBits<T>::Int aBits ) {
+  for( size_t i = aBegin; i < aEnd; ++i ) {
+    bool ok;
+    T error = checkElement<T, UseUlps>( aLhs[ i ], aRhs[ i ], aEpsilon, aMargin, aUlps, ok );
+    typename FloatBits<T>::Int bits;
+    std::memcpy( &bits, &error, sizeof( bits ) );
+    if( bits == aBits )
+      return i;
+  }
+  return aEnd;
+}
+
+/// The errors are not negative, their maximum is taken on their bits as
+/// signed integers, a reduction the compiler vectorizes unlike a floating
+/// point maximum.
+template <typename T, bool UseUlps>
+void approxRangeKernel( const T* aLhs, const T* aRhs, size_t aSize, const Tolerance& aTolerance, Detail::ApproxRangeStats& aStats ) {
+  typedef typename FloatBits<T>::Int Int;
+  const size_t kBlock = 64;
+  T epsilon = static_cast<T>( aTolerance.getEpsilon() );
+  T margin = static_cast<T>( aTolerance.getMargin() );
+  uint64_t ulps = aTolerance.getUlps();
+  aStats.count = 0;
+  aStats.first = 0;
+  aStats.worst = 0;
+  Int worstBits = 0;
+  for( size_t begin = 0; begin < aSize; begin += kBlock ) {
+    size_t end = begin + kBlock < aSize ? begin + kBlock : aSize;
+    unsigned bad = 0;
+    Int blockWorst = 0;
+    for( size_t i = begin; i < end; ++i ) {
+      bool ok;
+      T error = checkElement<T, UseUlps>( aLhs[ i ], aRhs[ i ], epsilon, margin, ulps, ok );
+      Int bits;
+      std::memcpy( &bits, &error, sizeof( bits ) );
+      bad += ok ? 0u : 1u;
+      blockWorst = bits > blockWorst ? bits : blockWorst;
+    }
+    if( bad && aStats.count == 0 )
+      aStats.first = findFirst<T, UseUlps>( aLhs, aRhs, begin, end, epsilon, margin, ulps );
+    aStats.count += bad;
+    if( blockWorst > worstBits ) {
+      worstBits = blockWorst;
+      aStats.worst = findError<T, UseUlps>( aLhs, aRhs, begin, end, epsilon, margin, ulps, worstBits );
+    }
+  }
+  T worstError;
+  std::memcpy( &worstError, &worstBits, sizeof( worstError ) );
+  aStats.worstError = worstError;
+}
+
+template <typename T>
+std::string exactToString( T aValue, bool aIsFloat ) {
+  std::ostringstream ss;
+  ss << std::setprecision( aIsFloat ? std::numeric_limits<float>::max_digits10 : std::numeric_limits<double>::max_digits10 ) << aValue;
+  if( aIsFloat )
+    ss << "f";
+  return ss.str();
+}
+
+} // namespace
+
+
+bool Tolerance::matches( float aLhs, float aRhs ) const {
+  bool ok;
+  if( mUlps > 0 )
+    checkElement<float, true>( aLhs, aRhs, static_cast<float>( mEpsilon ), static_cast<float>( mMargin ), mUlps, ok );
+  else
+    checkElement<float, false>( aLhs, aRhs, static_cast<float>( mEpsilon ), static_cast<float>( mMargin ), mUlps, ok );
+  return ok;
+}
+
+
+bool Tolerance::matches( double aLhs, double aRhs ) const {
+  bool ok;
+  if( mUlps > 0 )
+    checkElement<double, true>( aLhs, aRhs, mEpsilon, mMargin, mUlps, ok );
+  else
+    checkElement<double, false>( aLhs, aRhs, mEpsilon, mMargin, mUlps, ok );
+  return ok;
+}
+
+
+std::string Tolerance::toString() const {
+  std::ostringstream ss;
+  ss << "epsilon " << mEpsilon << ", margin " << mMargin << ", ulps " << mUlps;
+  return ss.str();
+}
+
+
+std::string toString( const Approx& aApprox ) {
+  return "Approx( " + exactToString( aApprox.getValue(), false ) + " ) [" + aApprox.getTolerance().toString() + "]";
+}
+
+namespace Detail {
+
+void approxRange( const float* aLhs, const float* aRhs, size_t aSize, const Tolerance& aTolerance, ApproxRangeStats& aStats ) {
+  if( aTolerance.getUlps() > 0 )
+    approxRangeKernel<float, true>( aLhs, aRhs, aSize, aTolerance, aStats );
+  else
+    approxRangeKernel<float, false>( aLhs, aRhs, aSize, aTolerance, aStats );
+}
+
+
+void approxRange( const double* aLhs, const double* aRhs, size_t aSize, const Tolerance& aTolerance, ApproxRangeStats& aStats ) {
+  if( aTolerance.getUlps() > 0 )
+    approxRangeKernel<double, true>( aLhs, aRhs, aSize, aTolerance, aStats );
+  else
+    approxRangeKernel<double, false>( aLhs, aRhs, aSize, aTolerance, aStats );
+}
+
+
+std::string approxRangeToString( double aLhsFirst, double aRhsFirst, double aLhsWorst, double aRhsWorst,
+                                 bool aIsFloat, size_t aLhsSize, size_t aRhsSize,
+                                 const ApproxRangeStats& aStats, const Tolerance& aTolerance ) {
+  size_t size = aLhsSize < aRhsSize ? aLhsSize : aRhsSize;
+  std::string out = std::to_string( aStats.count ) + " of " + std::to_string( size ) + " elements out of tolerance ("
+                    + aTolerance.toString() + ")";
+  if( aLhsSize != aRhsSize )
+    out += ", sizes differ: " + std::to_string( aLhsSize ) + " != " + std::to_string( aRhsSize );
+  if( aStats.count > 0 )
+    out += "\n  first [" + std::to_string( aStats.first ) + "] " + exactToString( aLhsFirst, aIsFloat ) + " != "
+           + exactToString( aRhsFirst, aIsFloat );
+  if( size > 0 )
+    out += "\n  worst [" + std::to_string( aStats.worst ) + "] " + exactToString( aLhsWorst, aIsFloat ) + " != "
+           + exactToString( aRhsWorst, aIsFloat ) + ", error " + exactToString( aStats.worstError, false );
+  return out;
+}
+
+} // namespace Detail
+
+} // namespace ACatch
@@ -0,0 +1,95 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+#include <cstring>
+
+#ifdef ACATCH_INTERNAL_HAS_SITE_SECTION
+// defined by the linker around the section, weak as the section may be empty
+extern "C" ACatch::AssertionSite* const __start_acatch_sites[] __attribute__( ( weak ) );
+extern "C" ACatch::AssertionSite* const __stop_acatch_sites[] __attribute__( ( weak ) );
+#endif
+
+namespace ACatch {
+
+#ifndef ACATCH_INTERNAL_HAS_SITE_SECTION
+namespace {
+
+std::mutex sSitesMutex;
+const AssertionSite* sSites = nullptr; ///< the reached sites, guarded by sSitesMutex
+
+} // namespace
+#endif
+
+
+std::string AssertionSite::getFirstFailure() const {
+  const std::string* values = firstFailure.load( std::memory_order_acquire );
+  return values ? *values : std::string();
+}
+
+
+std::string AssertionSite::location() const {
+  return std::string( file ) + ":" + std::to_string( line );
+}
+
+
+std::vector<const AssertionSite*> AssertionSite::getAll() {
+  std::vector<const AssertionSite*> sites;
+#ifdef ACATCH_INTERNAL_HAS_SITE_SECTION
+  if( __start_acatch_sites ) {
+    for( AssertionSite* const* site = __start_acatch_sites; site != __stop_acatch_sites; ++site )
+      sites.push_back( *site );
+  }
+#else
+  std::lock_guard<std::mutex> lg( sSitesMutex );
+  for( const AssertionSite* site = sSites; site; site = site->next )
+    sites.push_back( site );
+#endif
+  std::sort( sites.begin(), sites.end(), []( const AssertionSite* a, const AssertionSite* b ) {
+    int cmp = std::strcmp( a->file, b->file );
+    return cmp < 0 || ( cmp == 0 && a->line < b->line );
+  } );
+  return sites;
+}
+
+
+void AssertionSite::addCounts( uint64_t aHits, uint64_t aFails, const std::string* aFirstFailure ) {
+  if( !registered.load( std::memory_order_relaxed ) )
+    registerSite();
+  hits.fetch_add( aHits, std::memory_order_relaxed );
+  fails.fetch_add( aFails, std::memory_order_relaxed );
+  if( aFirstFailure && !firstFailure.load( std::memory_order_acquire ) )
+    recordFirstFailure( *aFirstFailure );
+}
+
+
+/// Mark the site as reached, without the linker section it is linked once in
+/// the list of the reached sites
+void AssertionSite::registerSite() {
+#ifdef ACATCH_INTERNAL_HAS_SITE_SECTION
+  registered.store( true, std::memory_order_relaxed );
+#else
+  std::lock_guard<std::mutex> lg( sSitesMutex );
+  if( registered.load( std::memory_order_relaxed ) )
+    return; // registered by another thread meanwhile
+  next = sSites;
+  sSites = this;
+  registered.store( true, std::memory_order_relaxed );
+#endif
+}
+
+
+void AssertionSite::recordFirstFailure( const std::string& aValues ) {
+  const std::string* expected = nullptr;
+  const std::string* values = new std::string( aValues );
+  if( !firstFailure.compare_exchange_strong( expected, values, std::memory_order_acq_rel ) )
+    delete values; // another thread was first
+}
+
+} // namespace ACatch
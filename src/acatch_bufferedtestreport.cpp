@@ -0,0 +1,126 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+namespace ACatch {
+
+BufferedTestReport::BufferedTestReport() {
+}
+
+
+BufferedTestReport::~BufferedTestReport() {
+}
+
+
+void BufferedTestReport::setProperty( const std::string& /*aProp*/, const std::string& /*aValue*/ ) {
+  // properties are set on the target report
+}
+
+
+void BufferedTestReport::reportTestCases( const ConstTestCaseInfoRefs& /*aInfos*/ ) {
+  // not buffered, listing is performed by the target report
+}
+
+
+void BufferedTestReport::reportShard( uint /*aShardIndex*/, uint /*aShardCount*/, const ConstTestCaseInfoRefs& /*aInfos*/ ) {
+  // not buffered, reported by the target report
+}
+
+
+void BufferedTestReport::reportTestCaseSkip( const TestCaseInfo& aInfo ) {
+  addEvent( EEvent::TestCaseSkip ).testInfo = &aInfo;
+}
+
+
+void BufferedTestReport::reportTestCaseStart( const TestCaseInfo& aInfo ) {
+  addEvent( EEvent::TestCaseStart ).testInfo = &aInfo;
+}
+
+
+void BufferedTestReport::reportTestSectionStart( const SectionInfo& aInfo ) {
+  addEvent( EEvent::TestSectionStart ).sectionInfo.reset( new SectionInfo( aInfo ) );
+}
+
+
+void BufferedTestReport::reportTestSectionSkip( const SectionInfo& aInfo ) {
+  addEvent( EEvent::TestSectionSkip ).sectionInfo.reset( new SectionInfo( aInfo ) );
+}
+
+
+void BufferedTestReport::reportTestSectionEnd( const SectionInfo& aInfo, TestCaseResult& aResult, const Timing& aTiming ) {
+  Event& ev = addEvent( EEvent::TestSectionEnd );
+  ev.sectionInfo.reset( new SectionInfo( aInfo ) );
+  ev.timing = aTiming;
+  ev.result.reset( new TestCaseResult() );
+  ev.result->takeState( aResult );
+}
+
+
+void BufferedTestReport::reportTestCaseEnd( const TestCaseInfo& aInfo, TestCaseResult& aResult, const Timing& aTiming ) {
+  Event& ev = addEvent( EEvent::TestCaseEnd );
+  ev.testInfo = &aInfo;
+  ev.timing = aTiming;
+  ev.result.reset( new TestCaseResult() );
+  ev.result->takeState( aResult );
+}
+
+
+void BufferedTestReport::reportLogNow( TestCaseResult& aResult ) {
+  Event& ev = addEvent( EEvent::LogNow );
+  ev.result.reset( new TestCaseResult() );
+  ev.result->takeState( aResult );
+}
+
+
+void BufferedTestReport::reportTestRun( const ConstTestCaseInfoRefs& /*aInfos*/, TestRunResult& /*aRunResult*/ ) {
+  // not buffered, the summary is reported by the target report
+}
+
+
+void BufferedTestReport::reportAssertionSites( const std::vector<const AssertionSite*>& /*aSites*/ ) {
+  // not buffered, the sites are reported by the target report
+}
+
+
+void BufferedTestReport::flushTo( ITestReport& aReport ) {
+  for( Event& ev : mEvents ) {
+    switch( ev.event ) {
+    case EEvent::TestCaseSkip:
+      aReport.reportTestCaseSkip( *ev.testInfo );
+      break;
+    case EEvent::TestCaseStart:
+      aReport.reportTestCaseStart( *ev.testInfo );
+      break;
+    case EEvent::TestSectionStart:
+      aReport.reportTestSectionStart( *ev.sectionInfo );
+      break;
+    case EEvent::TestSectionSkip:
+      aReport.reportTestSectionSkip( *ev.sectionInfo );
+      break;
+    case EEvent::TestSectionEnd:
+      aReport.reportTestSectionEnd( *ev.sectionInfo, *ev.result, ev.timing );
+      break;
+    case EEvent::TestCaseEnd:
+      aReport.reportTestCaseEnd( *ev.testInfo, *ev.result, ev.timing );
+      break;
+    case EEvent::LogNow:
+      aReport.reportLogNow( *ev.result );
+      break;
+    }
+  }
+  mEvents.clear();
+}
+
+
+BufferedTestReport::Event& BufferedTestReport::addEvent( EEvent aEvent ) {
+  mEvents.emplace_back( aEvent );
+  return mEvents.back();
+}
+
+} // namespace ACatch
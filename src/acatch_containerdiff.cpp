@@ -0,0 +1,364 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+namespace ACatch {
+
+namespace Detail {
+
+namespace {
+
+const size_t kShownHunks = 10;    ///< hunks shown by a sequence diff
+const size_t kShownElements = 8; ///< elements shown on each side of a hunk
+const size_t kShownEntries = 8;  ///< entries of each kind shown by an associative diff
+
+/// "[5]" or "[5..7]"
+void appendRange( std::string& aOut, size_t aBegin, size_t aCount ) {
+  aOut += "[" + std::to_string( aBegin );
+  if( aCount > 1 )
+    aOut += ".." + std::to_string( aBegin + aCount - 1 );
+  aOut += "]";
+}
+
+void appendElements( std::string& aOut, bool aLhs, size_t aBegin, size_t aCount,
+                     std::string ( *aFormat )( const void*, bool, size_t ), const void* aContext ) {
+  size_t shown = aCount < kShownElements ? aCount : kShownElements;
+  aOut += " { ";
+  for( size_t i = 0; i < shown; ++i ) {
+    if( i > 0 )
+      aOut += ", ";
+    aOut += aFormat( aContext, aLhs, aBegin + i );
+  }
+  if( aCount > shown )
+    aOut += ", ... " + std::to_string( aCount - shown ) + " more";
+  aOut += " }";
+}
+
+void appendEntries( std::string& aOut, const char* aMark, const std::vector<std::string>& aShown, size_t aCount ) {
+  for( const std::string& entry : aShown )
+    aOut += std::string( "\n  " ) + aMark + " " + entry;
+  if( aCount > aShown.size() )
+    aOut += std::string( "\n  " ) + aMark + " ... " + std::to_string( aCount - aShown.size() ) + " more";
+}
+
+/// Linear space variant of the Myers diff: the middle snake of the shortest
+/// edit script splits the sequences, both halves are diffed recursively.
+/// Each search is bounded by the edit budget, all of them by the step budget.
+class SequenceDiffer
+{
+public:
+  SequenceDiffer( size_t aLhsSize, size_t aRhsSize, bool ( *aEqual )( const void*, size_t, size_t ), const void* aContext,
+                  size_t aMaxEdits, size_t aMaxSteps, std::vector<DiffHunk>& aHunks )
+      : mEqual( aEqual )
+      , mContext( aContext )
+      , mMaxEdits( static_cast<Index>( std::min<size_t>( aMaxEdits, PTRDIFF_MAX ) ) )
+      , mEdits( 0 )
+      , mMaxSteps( aMaxSteps )
+      , mSteps( 0 )
+      , mHunks( aHunks ) {
+    mLimit = static_cast<Index>( std::min( ( aLhsSize + aRhsSize + 1 ) / 2, aMaxEdits / 2 + 1 ) );
+    mOffset = mLimit + 1;
+    mForward.resize( static_cast<size_t>( 2 * mOffset + 1 ) );
+    mBackward.resize( static_cast<size_t>( 2 * mOffset + 1 ) );
+  }
+
+  /// Diff [aLhsBegin, aLhsEnd) and [aRhsBegin, aRhsEnd), false if a budget is exceeded
+  bool compare( size_t aLhsBegin, size_t aLhsEnd, size_t aRhsBegin, size_t aRhsEnd ) {
+    while( aLhsBegin < aLhsEnd && aRhsBegin < aRhsEnd && equal( aLhsBegin, aRhsBegin ) ) {
+      ++aLhsBegin;
+      ++aRhsBegin;
+    }
+    while( aLhsBegin < aLhsEnd && aRhsBegin < aRhsEnd && equal( aLhsEnd - 1, aRhsEnd - 1 ) ) {
+      --aLhsEnd;
+      --aRhsEnd;
+    }
+    if( aLhsBegin == aLhsEnd || aRhsBegin == aRhsEnd ) {
+      mEdits += static_cast<Index>( aLhsEnd - aLhsBegin + aRhsEnd - aRhsBegin );
+      if( mEdits > mMaxEdits )
+        return false;
+      if( aLhsBegin < aLhsEnd || aRhsBegin < aRhsEnd )
+        add( aLhsBegin, aLhsEnd - aLhsBegin, aRhsBegin, aRhsEnd - aRhsBegin );
+      return true;
+    }
+    size_t snake[ 4 ];
+    if( !middleSnake( aLhsBegin, aLhsEnd, aRhsBegin, aRhsEnd, snake ) )
+      return false;
+    return compare( aLhsBegin, snake[ 0 ], aRhsBegin, snake[ 1 ] ) && compare( snake[ 2 ], aLhsEnd, snake[ 3 ], aRhsEnd );
+  }
+
+private:
+  typedef std::ptrdiff_t Index;
+
+  bool ( *mEqual )( const void*, size_t, size_t );
+  const void* mContext;
+  Index mMaxEdits;
+  Index mEdits; ///< insertions and deletions found so far
+  size_t mMaxSteps;
+  size_t mSteps;
+  std::vector<DiffHunk>& mHunks;
+  Index mLimit;                 ///< rounds of a middle snake search
+  Index mOffset;                ///< index of the diagonal 0
+  std::vector<Index> mForward;  ///< furthest x on each diagonal from the start
+  std::vector<Index> mBackward; ///< furthest x on each diagonal from the end
+
+  bool equal( size_t aLhs, size_t aRhs ) {
+    ++mSteps;
+    return mEqual( mContext, aLhs, aRhs );
+  }
+
+  /// The hunks are added in order, adjacent ones are merged
+  void add( size_t aLhsBegin, size_t aLhsCount, size_t aRhsBegin, size_t aRhsCount ) {
+    if( !mHunks.empty() ) {
+      DiffHunk& last = mHunks.back();
+      if( last.lhsBegin + last.lhsCount == aLhsBegin && last.rhsBegin + last.rhsCount == aRhsBegin ) {
+        last.lhsCount += aLhsCount;
+        last.rhsCount += aRhsCount;
+        return;
+      }
+    }
+    mHunks.push_back( DiffHunk{ aLhsBegin, aLhsCount, aRhsBegin, aRhsCount } );
+  }
+
+  /// The snake in the middle of a shortest edit script as { x, y, u, v }, the
+  /// ends of both sequences differ
+  bool middleSnake( size_t aLhsBegin, size_t aLhsEnd, size_t aRhsBegin, size_t aRhsEnd, size_t* aSnake ) {
+    const Index n = static_cast<Index>( aLhsEnd - aLhsBegin );
+    const Index m = static_cast<Index>( aRhsEnd - aRhsBegin );
+    const Index delta = n - m;
+    const bool odd = ( delta & 1 ) != 0;
+    Index* forward = mForward.data() + mOffset;
+    Index* backward = mBackward.data() + mOffset;
+    forward[ 1 ] = 0;
+    backward[ 1 ] = 0;
+    for( Index d = 0; d <= mLimit && 2 * d - 1 <= mMaxEdits; ++d ) {
+      for( Index k = -d; k <= d; k += 2 ) {
+        Index x = ( k == -d || ( k != d && forward[ k - 1 ] < forward[ k + 1 ] ) ) ? forward[ k + 1 ] : forward[ k - 1 ] + 1;
+        Index y = x - k;
+        Index startX = x;
+        Index startY = y;
+        while( x < n && y < m && equal( aLhsBegin + static_cast<size_t>( x ), aRhsBegin + static_cast<size_t>( y ) ) ) {
+          ++x;
+          ++y;
+        }
+        forward[ k ] = x;
+        if( odd && k >= delta - ( d - 1 ) && k <= delta + ( d - 1 ) && x + backward[ delta - k ] >= n ) {
+          aSnake[ 0 ] = aLhsBegin + static_cast<size_t>( startX );
+          aSnake[ 1 ] = aRhsBegin + static_cast<size_t>( startY );
+          aSnake[ 2 ] = aLhsBegin + static_cast<size_t>( x );
+          aSnake[ 3 ] = aRhsBegin + static_cast<size_t>( y );
+          return true;
+        }
+      }
+      for( Index k = -d; k <= d; k += 2 ) {
+        Index x = ( k == -d || ( k != d && backward[ k - 1 ] < backward[ k + 1 ] ) ) ? backward[ k + 1 ] : backward[ k - 1 ] + 1;
+        Index y = x - k;
+        Index startX = x;
+        Index startY = y;
+        while( x < n && y < m && equal( aLhsEnd - 1 - static_cast<size_t>( x ), aRhsEnd - 1 - static_cast<size_t>( y ) ) ) {
+          ++x;
+          ++y;
+        }
+        backward[ k ] = x;
+        if( !odd && delta - k >= -d && delta - k <= d && x + forward[ delta - k ] >= n ) {
+          if( 2 * d > mMaxEdits )
+            return false;
+          aSnake[ 0 ] = aLhsEnd - static_cast<size_t>( x );
+          aSnake[ 1 ] = aRhsEnd - static_cast<size_t>( y );
+          aSnake[ 2 ] = aLhsEnd - static_cast<size_t>( startX );
+          aSnake[ 3 ] = aRhsEnd - static_cast<size_t>( startY );
+          return true;
+        }
+      }
+      if( mSteps > mMaxSteps )
+        return false;
+    }
+    return false;
+  }
+};
+
+
+/// Render the hunks of a sequence diff, aFormat converts the element aIndex of a side
+std::string sequenceDiffToString( size_t aLhsSize, size_t aRhsSize, size_t aOffset, const std::vector<DiffHunk>& aHunks,
+                                  bool aComplete, std::string ( *aFormat )( const void*, bool, size_t ), const void* aContext ) {
+  std::string out;
+  if( aLhsSize != aRhsSize )
+    out += "\n  sizes differ: " + std::to_string( aLhsSize ) + " != " + std::to_string( aRhsSize );
+  if( aHunks.empty() )
+    return out;
+  out += "\n  first mismatch at [" + std::to_string( aOffset + aHunks.front().lhsBegin ) + "]";
+  if( aComplete )
+    out += ", " + std::to_string( aHunks.size() ) + ( aHunks.size() == 1 ? " change" : " changes" );
+  else
+    out += ", too many changes to diff, the range differing is shown";
+  size_t shown = aHunks.size() < kShownHunks ? aHunks.size() : kShownHunks;
+  for( size_t i = 0; i < shown; ++i ) {
+    const DiffHunk& hunk = aHunks[ i ];
+    if( hunk.lhsCount > 0 ) {
+      out += "\n  - ";
+      appendRange( out, aOffset + hunk.lhsBegin, hunk.lhsCount );
+      appendElements( out, true, hunk.lhsBegin, hunk.lhsCount, aFormat, aContext );
+    }
+    if( hunk.rhsCount > 0 ) {
+      out += "\n  + ";
+      appendRange( out, aOffset + hunk.rhsBegin, hunk.rhsCount );
+      appendElements( out, false, hunk.rhsBegin, hunk.rhsCount, aFormat, aContext );
+    }
+  }
+  if( aHunks.size() > shown )
+    out += "\n  ... " + std::to_string( aHunks.size() - shown ) + " more changes";
+  return out;
+}
+
+
+/// Render the entries only in lhs, only in rhs and changed
+std::string associativeDiffToString( size_t aLhsSize, size_t aRhsSize, const std::vector<std::string>& aDeleted, size_t aDeletedCount,
+                                     const std::vector<std::string>& aInserted, size_t aInsertedCount,
+                                     const std::vector<std::string>& aChanged, size_t aChangedCount ) {
+  std::string out;
+  if( aLhsSize != aRhsSize )
+    out += "\n  sizes differ: " + std::to_string( aLhsSize ) + " != " + std::to_string( aRhsSize );
+  out += "\n  " + std::to_string( aDeletedCount ) + " only in lhs, " + std::to_string( aInsertedCount ) + " only in rhs, " +
+         std::to_string( aChangedCount ) + " changed";
+  appendEntries( out, "-", aDeleted, aDeletedCount );
+  appendEntries( out, "+", aInserted, aInsertedCount );
+  appendEntries( out, "~", aChanged, aChangedCount );
+  return out;
+}
+
+
+/// The entries only in lhs, only in rhs and changed, the first ones of each kind kept
+struct AssociativeDiff {
+  std::vector<std::string> deleted;
+  std::vector<std::string> inserted;
+  std::vector<std::string> changed;
+  size_t deletedCount = 0;
+  size_t insertedCount = 0;
+  size_t changedCount = 0;
+
+  static void add( std::vector<std::string>& aShown, size_t& aCount, std::string aEntry ) {
+    if( aShown.size() < kShownEntries )
+      aShown.push_back( std::move( aEntry ) );
+    ++aCount;
+  }
+};
+
+/// The part of two sequences between their common prefix and suffix
+struct SequenceDiffContext {
+  const ContainerDiffInput* input;
+  size_t offset;
+
+  static bool equal( const void* aContext, size_t aLhs, size_t aRhs ) {
+    const SequenceDiffContext& context = *static_cast<const SequenceDiffContext*>( aContext );
+    return context.input->equal( context.input->lhs[ context.offset + aLhs ], context.input->rhs[ context.offset + aRhs ] );
+  }
+
+  static std::string format( const void* aContext, bool aLhs, size_t aIndex ) {
+    const SequenceDiffContext& context = *static_cast<const SequenceDiffContext*>( aContext );
+    const std::vector<const void*>& entries = aLhs ? context.input->lhs : context.input->rhs;
+    return context.input->format( entries[ context.offset + aIndex ] );
+  }
+};
+
+/// Only the part between the common prefix and the common suffix is diffed
+std::string diffSequenceEntries( const ContainerDiffInput& aInput ) {
+  const std::vector<const void*>& lhs = aInput.lhs;
+  const std::vector<const void*>& rhs = aInput.rhs;
+  size_t prefix = 0;
+  while( prefix < lhs.size() && prefix < rhs.size() && aInput.equal( lhs[ prefix ], rhs[ prefix ] ) )
+    ++prefix;
+  size_t suffix = 0;
+  while( prefix + suffix < lhs.size() && prefix + suffix < rhs.size() &&
+         aInput.equal( lhs[ lhs.size() - 1 - suffix ], rhs[ rhs.size() - 1 - suffix ] ) )
+    ++suffix;
+  SequenceDiffContext context{ &aInput, prefix };
+  std::vector<DiffHunk> hunks;
+  bool complete = diffSequences( lhs.size() - prefix - suffix, rhs.size() - prefix - suffix, &SequenceDiffContext::equal, &context,
+                                 256, 10000000, hunks );
+  return sequenceDiffToString( lhs.size(), rhs.size(), prefix, hunks, complete, &SequenceDiffContext::format, &context );
+}
+
+/// Ordered containers are merged on their keys, unordered ones are looked up
+std::string diffAssociativeEntries( const ContainerDiffInput& aInput ) {
+  AssociativeDiff diff;
+  if( aInput.less ) {
+    const void* container = aInput.lhsContainer;
+    auto lhs = aInput.lhs.begin();
+    auto rhs = aInput.rhs.begin();
+    while( lhs != aInput.lhs.end() || rhs != aInput.rhs.end() ) {
+      if( rhs == aInput.rhs.end() || ( lhs != aInput.lhs.end() && aInput.less( container, *lhs, *rhs ) ) ) {
+        AssociativeDiff::add( diff.deleted, diff.deletedCount, aInput.format( *lhs ) );
+        ++lhs;
+      } else if( lhs == aInput.lhs.end() || aInput.less( container, *rhs, *lhs ) ) {
+        AssociativeDiff::add( diff.inserted, diff.insertedCount, aInput.format( *rhs ) );
+        ++rhs;
+      } else {
+        if( !aInput.same( *lhs, *rhs ) )
+          AssociativeDiff::add( diff.changed, diff.changedCount, aInput.formatChange( *lhs, *rhs ) );
+        ++lhs;
+        ++rhs;
+      }
+    }
+  } else {
+    for( const void* entry : aInput.lhs ) {
+      const void* found = aInput.find( aInput.rhsContainer, entry );
+      if( !found )
+        AssociativeDiff::add( diff.deleted, diff.deletedCount, aInput.format( entry ) );
+      else if( !aInput.same( entry, found ) )
+        AssociativeDiff::add( diff.changed, diff.changedCount, aInput.formatChange( entry, found ) );
+    }
+    for( const void* entry : aInput.rhs ) {
+      if( !aInput.find( aInput.lhsContainer, entry ) )
+        AssociativeDiff::add( diff.inserted, diff.insertedCount, aInput.format( entry ) );
+    }
+  }
+  return associativeDiffToString( aInput.lhs.size(), aInput.rhs.size(), diff.deleted, diff.deletedCount, diff.inserted,
+                                  diff.insertedCount, diff.changed, diff.changedCount );
+}
+
+std::string containerSummary( size_t aSize ) {
+  return "{ " + std::to_string( aSize ) + " elements }";
+}
+
+} // namespace
+
+
+bool diffSequences( size_t aLhsSize, size_t aRhsSize, bool ( *aEqual )( const void*, size_t, size_t ), const void* aContext,
+                    size_t aMaxEdits, size_t aMaxSteps, std::vector<DiffHunk>& aHunks ) {
+  aHunks.clear();
+  SequenceDiffer differ( aLhsSize, aRhsSize, aEqual, aContext, aMaxEdits, aMaxSteps, aHunks );
+  if( differ.compare( 0, aLhsSize, 0, aRhsSize ) )
+    return true;
+  // the part between the common prefix and suffix is a single change
+  size_t prefix = 0;
+  while( prefix < aLhsSize && prefix < aRhsSize && aEqual( aContext, prefix, prefix ) )
+    ++prefix;
+  size_t suffix = 0;
+  while( prefix + suffix < aLhsSize && prefix + suffix < aRhsSize && aEqual( aContext, aLhsSize - suffix - 1, aRhsSize - suffix - 1 ) )
+    ++suffix;
+  aHunks.clear();
+  aHunks.push_back( DiffHunk{ prefix, aLhsSize - prefix - suffix, prefix, aRhsSize - prefix - suffix } );
+  return false;
+}
+
+
+bool addContainerDiff( ExpressionCapture& aCapture, const ContainerDiffInput& aInput, const char* aOperator ) {
+  if( aInput.lhs.size() <= kDiffFullSize && aInput.rhs.size() <= kDiffFullSize )
+    return false;
+  std::string diff = aInput.find ? diffAssociativeEntries( aInput ) : diffSequenceEntries( aInput );
+  if( diff.empty() )
+    return false;
+  aCapture.add( containerSummary( aInput.lhs.size() ) );
+  aCapture.add( std::string( "\"" ) + aOperator + "\"" );
+  aCapture.add( containerSummary( aInput.rhs.size() ) + diff );
+  return true;
+}
+
+} // namespace Detail
+
+} // namespace ACatch
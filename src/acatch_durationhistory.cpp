@@ -0,0 +1,63 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+#include <fstream>
+
+namespace ACatch {
+
+/// The file has a line for each test case: "<seconds>\t<name>"
+bool DurationHistory::load( const std::string& aPath ) {
+  std::ifstream file( aPath );
+  if( !file )
+    return false;
+
+  std::lock_guard<std::mutex> lg( mMutex );
+  std::string line;
+  while( std::getline( file, line ) ) {
+    std::size_t tab = line.find( '\t' );
+    if( tab == std::string::npos )
+      continue;
+    std::istringstream ss( line.substr( 0, tab ) );
+    double seconds;
+    if( ss >> seconds )
+      mDurations[ line.substr( tab + 1 ) ] = seconds;
+  }
+  return true;
+}
+
+
+bool DurationHistory::save( const std::string& aPath ) const {
+  std::ofstream file( aPath, std::ios::trunc );
+  if( !file )
+    return false;
+
+  std::lock_guard<std::mutex> lg( mMutex );
+  for( const auto& d : mDurations )
+    file << d.second << "\t" << d.first << "\n";
+  return !!file;
+}
+
+
+bool DurationHistory::getDuration( const std::string& aName, double& aSeconds ) const {
+  std::lock_guard<std::mutex> lg( mMutex );
+  auto it = mDurations.find( aName );
+  if( it == mDurations.end() )
+    return false;
+  aSeconds = it->second;
+  return true;
+}
+
+
+void DurationHistory::setDuration( const std::string& aName, double aSeconds ) {
+  std::lock_guard<std::mutex> lg( mMutex );
+  mDurations[ aName ] = aSeconds;
+}
+
+} // namespace ACatch
@@ -0,0 +1,16 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+namespace ACatch {
+
+// the common comparisons declared extern in acatch_light.hpp
+ACATCH_INTERNAL_EXPRESSION_INSTANCES( template )
+
+} // namespace ACatch
@@ -8,10 +8,46 @@
 
 #include "acatch/acatch_core.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
 namespace ACatch {
 
 ACatch::Framework* ACatch::Framework::sInstance = nullptr;
 
+namespace {
+
+/// Names of the tracker and its parents, from the test case down to the tracker
+std::vector<std::string> getSectionPath( const ITracker& aTracker ) {
+  std::vector<std::string> path;
+  for( const ITracker* p = &aTracker; p->pparent(); p = p->pparent() )
+    path.push_back( p->name() );
+  std::reverse( path.begin(), path.end() );
+  return path;
+}
+
+/// Check if a section is on the given path, either as an ancestor or a descendant.
+/// The names are compared one by one as they may contain dots.
+bool isOnSectionPath( const std::vector<std::string>& aPath, const std::vector<std::string>& aSection ) {
+  size_t depth = std::min( aPath.size(), aSection.size() );
+  return std::equal( aPath.begin(), aPath.begin() + depth, aSection.begin() );
+}
+
+/// Split a list of names separated by commas or spaces
+std::vector<std::string> splitNames( const std::string& aNames ) {
+  std::vector<std::string> names;
+  size_t pos = 0;
+  while( ( pos = aNames.find_first_not_of( ", \t", pos ) ) != std::string::npos ) {
+    size_t end = aNames.find_first_of( ", \t", pos );
+    names.push_back( aNames.substr( pos, end - pos ) );
+    pos = end;
+  }
+  return names;
+}
+
+} // namespace
+
 Framework& theACatch() {
   if( !Framework::sInstance )
     Framework::sInstance = new Framework;
@@ -30,12 +66,19 @@ void theACatchShutdown() {
 
 Framework::Framework()
     : mBreakOnError( Break_Never )
+    , mJobs( 1 )
+    , mIsolated( false )
+    , mForkSections( false )
+    , mRepeat( 1 )
+    , mZygote( false )
+    , mShardIndex( 0 )
+    , mShardCount( 1 )
+    , mDefaultTimeout( 0 )
     , mTestReport( new SimpleTestReport() )
-    , mTrackerContext( nullptr )
-    , mTestCaseTracker( nullptr )
-    , mCurrentResult( nullptr )
-    , mInAssertTest( false )
-    , mPreInitCompleted( false ) {
+    , mPreInitCompleted( false )
+    , mMainContext( mTestReport )
+    , mFallbackContext( nullptr )
+    , mUnboundChecks( nullptr ) {
 }
 
 
@@ -73,22 +116,391 @@ void Framework::setBreak( EBreak aBreak ) {
 }
 
 
+/// Set the number of worker threads running the test cases (0: one per hardware thread)
+void Framework::setJobs( uint aJobs ) {
+  if( aJobs == 0 )
+    aJobs = std::max( 1u, std::thread::hardware_concurrency() );
+  mJobs = aJobs;
+}
+
+
+/// Run the test cases in forked worker processes, the number of workers is set by setJobs
+void Framework::setIsolated( bool aIsolated ) {
+  mIsolated = aIsolated;
+}
+
+
+/// Execute the sections of all the test cases in forked processes, as with the
+/// TestCaseInfo::ForkSections flag
+void Framework::setForkSections( bool aForkSections ) {
+  mForkSections = aForkSections;
+}
+
+
+/// Run the selected test cases several times
+void Framework::setRepeat( uint aRepeat ) {
+  mRepeat = std::max( 1u, aRepeat );
+}
+
+
+/// Bound the messages logged between two reports: the first aFirst and the
+/// last aLast messages of each thread are kept, the others are only counted.
+void Framework::setLogRetention( uint aFirst, uint aLast ) {
+  TestCaseResult::setDefaultRetention( aFirst, aLast );
+}
+
+
+void Framework::setMaxStringLength( uint aLength ) {
+  ::ACatch::setMaxStringLength( aLength );
+}
+
+
+/// Run each repetition of the test cases in a process forked from the state
+/// after the preinits: every run starts from the same warmed state and the
+/// preinits are not executed again. The isolated workers are always forked
+/// from that state.
+void Framework::setZygote( bool aZygote ) {
+  mZygote = aZygote;
+}
+
+
+/// Run only the test cases of the given shard. The test cases are assigned by a
+/// stable hash of their name, the duration history only orders them in the shard.
+void Framework::setShard( uint aShardIndex, uint aShardCount ) {
+  ACATCH_INTERNAL_ASSERT( aShardCount > 0 && aShardIndex < aShardCount );
+  mShardIndex = aShardIndex;
+  mShardCount = aShardCount;
+}
+
+
+/// Measure the duration of the test cases and store them in a history file.
+/// When set, the test cases are executed longest first based on the previous runs.
+void Framework::setDurationHistoryFile( const std::string& aPath ) {
+  mDurationHistoryFile = aPath;
+  if( !mDurationHistoryFile.empty() )
+    mTestRegistry.getDurationHistory().load( mDurationHistoryFile );
+}
+
+
+/// Time budget of the test cases without their own timeout (0: no timeout).
+/// A test case exceeding its budget is reported and the process is terminated,
+/// in isolated mode only the worker process is terminated.
+void Framework::setDefaultTimeout( double aSeconds ) {
+  mDefaultTimeout = aSeconds;
+}
+
+
+double Framework::getTimeout( const TestCaseInfo& aInfo ) const {
+  return aInfo.timeoutSeconds > 0 ? aInfo.timeoutSeconds : mDefaultTimeout;
+}
+
+
+/// All the test cases of the current shard in run order
+std::vector<ITestCase*> Framework::getShardTests() {
+  return mTestRegistry.getShardTests(
+    mDurationHistoryFile.empty() ? TestRegistry::RunOrder::InLexicographicalOrder
+                                 : TestRegistry::RunOrder::InDurationHistoryOrder,
+    mShardIndex, mShardCount );
+}
+
+
+void Framework::recordDuration( const TestCaseInfo& aInfo, double aSeconds ) {
+  if( !mDurationHistoryFile.empty() )
+    mTestRegistry.getDurationHistory().setDuration( aInfo.name, aSeconds );
+}
+
+
+/// Parse the runner options. Arguments that are not options are added as filters.
+/// Supported options:
+///   --jobs N, -j N    number of worker threads/processes (0: one per hardware thread)
+///   --isolate         run the test cases in worker processes, a crash aborts only the running test case
+///   --fork-sections   execute each section in a process forked at its entry
+///   --repeat N        run the test cases N times
+///   --zygote          run each repetition in a process forked after the preinits
+///   --sites           count the hits of the assertion sites and report every site, including the sites never reached
+///   --log-first N     number of messages kept at the start of a report, per thread
+///   --log-last N      number of messages kept at the end of a report, per thread
+///   --max-string-length N  longest string rendered in full, the middle of longer strings is elided (0: no limit)
+///   --shard-count N   split the test cases into N shards
+///   --shard-index K   run the K-th (0 based) shard
+///   --history FILE    record the durations of the test cases and run the longest first
+///   --timeout SECONDS default time budget of the test cases
+bool Framework::parseCommandLine( int aArgc, const char* const* aArgv ) {
+  uint shardIndex = 0;
+  uint shardCount = 1;
+  for( int i = 1; i < aArgc; ++i ) {
+    std::string arg = aArgv[ i ];
+    auto uintValue = [&]( uint& aValue ) {
+      if( i + 1 >= aArgc ) {
+        std::cerr << "missing value for " << arg << "\n";
+        return false;
+      }
+      std::string value = aArgv[ ++i ];
+      if( value.empty() || value.find_first_not_of( "0123456789" ) != std::string::npos ) {
+        std::cerr << "invalid value for " << arg << ": " << value << "\n";
+        return false;
+      }
+      aValue = static_cast<uint>( std::stoul( value ) );
+      return true;
+    };
+
+    if( arg == "--jobs" || arg == "-j" ) {
+      uint jobs;
+      if( !uintValue( jobs ) )
+        return false;
+      setJobs( jobs );
+    } else if( arg == "--isolate" ) {
+      setIsolated( true );
+    } else if( arg == "--fork-sections" ) {
+      setForkSections( true );
+    } else if( arg == "--repeat" ) {
+      uint repeat;
+      if( !uintValue( repeat ) )
+        return false;
+      setRepeat( repeat );
+    } else if( arg == "--zygote" ) {
+      setZygote( true );
+    } else if( arg == "--sites" ) {
+      mTestReport->setProperty( "sites", "all" );
+      AssertionSite::setCountHits( true );
+    } else if( arg == "--log-first" ) {
+      uint first;
+      if( !uintValue( first ) )
+        return false;
+      setLogRetention( first, static_cast<uint>( TestCaseResult::getDefaultRetentionLast() ) );
+    } else if( arg == "--log-last" ) {
+      uint last;
+      if( !uintValue( last ) )
+        return false;
+      setLogRetention( static_cast<uint>( TestCaseResult::getDefaultRetentionFirst() ), last );
+    } else if( arg == "--max-string-length" ) {
+      uint length;
+      if( !uintValue( length ) )
+        return false;
+      setMaxStringLength( length );
+    } else if( arg == "--shard-count" ) {
+      if( !uintValue( shardCount ) )
+        return false;
+    } else if( arg == "--shard-index" ) {
+      if( !uintValue( shardIndex ) )
+        return false;
+    } else if( arg == "--timeout" ) {
+      if( i + 1 >= aArgc ) {
+        std::cerr << "missing value for " << arg << "\n";
+        return false;
+      }
+      std::istringstream ss( aArgv[ ++i ] );
+      double seconds;
+      if( !( ss >> seconds ) || seconds < 0 ) {
+        std::cerr << "invalid value for " << arg << ": " << aArgv[ i ] << "\n";
+        return false;
+      }
+      setDefaultTimeout( seconds );
+    } else if( arg == "--history" ) {
+      if( i + 1 >= aArgc ) {
+        std::cerr << "missing value for " << arg << "\n";
+        return false;
+      }
+      setDurationHistoryFile( aArgv[ ++i ] );
+    } else if( startsWith( arg, "-" ) ) {
+      std::cerr << "unknown option: " << arg << "\n";
+      return false;
+    } else {
+      addFilter( arg );
+    }
+  }
+
+  if( shardCount == 0 || shardIndex >= shardCount ) {
+    std::cerr << "invalid shard: " << shardIndex << " of " << shardCount << "\n";
+    return false;
+  }
+  setShard( shardIndex, shardCount );
+  return true;
+}
+
+
+RunContext& Framework::context() {
+  RunContext* ctx = RunContext::current();
+  if( !ctx )
+    ctx = mFallbackContext.load( std::memory_order_acquire );
+  return ctx ? *ctx : mMainContext;
+}
+
+
+const RunContext& Framework::context() const {
+  const RunContext* ctx = RunContext::current();
+  if( !ctx )
+    ctx = mFallbackContext.load( std::memory_order_acquire );
+  return ctx ? *ctx : mMainContext;
+}
+
+
 void Framework::registerTestCase( ITestCase* aTestCase ) {
   mTestRegistry.registerTest( aTestCase );
 }
 
 
-void Framework::registerPreInit( FnPreInit aPreInit ) {
-  mTestRegistry.registerPreInit( aPreInit );
+void Framework::registerPreInit( FnPreInit aPreInit, const PreInitInfo& aInfo ) {
+  mTestRegistry.registerPreInit( aPreInit, aInfo );
 }
 
 
-/// Execute all the preinit functions if not yet executed
-void Framework::runPreinits() {
-  for( auto fn : mTestRegistry.getAllPreinits() ) {
-    fn();
+/// Execute the preinit functions needed by the selected test cases: the unnamed
+/// ones in registration order and the named ones required by the test cases or
+/// by other needed preinits. A preinit starts once its dependencies are done.
+/// The unnamed ones and their dependencies are executed first on the calling
+/// thread, then the independent named ones concurrently on up to setJobs threads.
+/// Return false if a dependency is unknown or cyclic. An exception thrown by a
+/// preinit is rethrown once the running ones are done.
+bool Framework::runPreinits() {
+  const std::vector<TestRegistry::PreInit>& preinits = mTestRegistry.getAllPreinits();
+  const size_t count = preinits.size();
+
+  std::map<std::string, size_t> byName;
+  for( size_t i = 0; i < count; ++i ) {
+    if( !preinits[ i ].info.name.empty() && !byName.emplace( preinits[ i ].info.name, i ).second ) {
+      std::cerr << "duplicate preinit: " << preinits[ i ].info.name << "\n";
+      return false;
+    }
+  }
+
+  // the needed preinits and their dependencies
+  std::vector<bool> needed( count, false );
+  std::vector<std::vector<size_t>> dependencies( count );
+  std::vector<size_t> pending;
+  size_t lastUnnamed = count;
+  for( size_t i = 0; i < count; ++i ) {
+    if( preinits[ i ].info.name.empty() ) {
+      needed[ i ] = true;
+      pending.push_back( i );
+      if( lastUnnamed < count )
+        dependencies[ i ].push_back( lastUnnamed );
+      lastUnnamed = i;
+    }
+  }
+  auto require = [&]( const std::string& aNames, const std::string& aRequiredBy, std::vector<size_t>* aDependencies ) {
+    bool ok = true;
+    for( const std::string& name : splitNames( aNames ) ) {
+      auto it = byName.find( name );
+      if( it == byName.end() ) {
+        std::cerr << "unknown preinit " << name << " required by " << aRequiredBy << "\n";
+        ok = false;
+        continue;
+      }
+      if( aDependencies )
+        aDependencies->push_back( it->second );
+      if( !needed[ it->second ] ) {
+        needed[ it->second ] = true;
+        pending.push_back( it->second );
+      }
+    }
+    return ok;
+  };
+
+  bool ok = true;
+  for( ITestCase* tc : getShardTests() ) {
+    if( matchFilter( tc->testInfo().name ) )
+      ok &= require( tc->testInfo().preinits, tc->testInfo().name, nullptr );
+  }
+  while( !pending.empty() ) {
+    size_t i = pending.back();
+    pending.pop_back();
+    const std::string& name = preinits[ i ].info.name;
+    ok &= require( preinits[ i ].info.dependencies, name.empty() ? "an unnamed preinit" : name, &dependencies[ i ] );
+  }
+  if( !ok )
+    return false;
+
+  // the unnamed preinits and their dependencies set up the process as main()
+  // would: they are executed on the calling thread before the others
+  std::vector<bool> onCaller( count, false );
+  std::vector<size_t> unnamed;
+  for( size_t i = 0; i < count; ++i ) {
+    if( preinits[ i ].info.name.empty() )
+      unnamed.push_back( i );
+  }
+  while( !unnamed.empty() ) {
+    size_t i = unnamed.back();
+    unnamed.pop_back();
+    if( onCaller[ i ] )
+      continue;
+    onCaller[ i ] = true;
+    unnamed.insert( unnamed.end(), dependencies[ i ].begin(), dependencies[ i ].end() );
+  }
+
+  for( bool callerPhase : { true, false } ) {
+    // execute the preinits of the phase as their dependencies complete, the
+    // dependencies of the other phase are done at this point
+    std::vector<uint> waiting( count, 0 );
+    std::vector<std::vector<size_t>> dependents( count );
+    std::deque<size_t> ready;
+    size_t total = 0;
+    for( size_t i = 0; i < count; ++i ) {
+      if( !needed[ i ] || onCaller[ i ] != callerPhase )
+        continue;
+      ++total;
+      for( size_t d : dependencies[ i ] ) {
+        if( onCaller[ d ] == callerPhase ) {
+          ++waiting[ i ];
+          dependents[ d ].push_back( i );
+        }
+      }
+      if( waiting[ i ] == 0 )
+        ready.push_back( i );
+    }
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    size_t running = 0;
+    size_t done = 0;
+    std::exception_ptr error;
+    auto worker = [&]() {
+      std::unique_lock<std::mutex> lock( mutex );
+      for( ;; ) {
+        wakeUp.wait( lock, [&] { return !ready.empty() || running == 0; } );
+        if( ready.empty() || error )
+          break;
+        size_t i = ready.front();
+        ready.pop_front();
+        ++running;
+        lock.unlock();
+        std::exception_ptr failure;
+        try {
+          preinits[ i ].function();
+        } catch( ... ) {
+          failure = std::current_exception();
+        }
+        lock.lock();
+        --running;
+        ++done;
+        if( failure && !error )
+          error = failure;
+        for( size_t d : dependents[ i ] ) {
+          if( --waiting[ d ] == 0 )
+            ready.push_back( d );
+        }
+        wakeUp.notify_all();
+      }
+      wakeUp.notify_all();
+    };
+
+    std::vector<std::thread> threads;
+    const size_t threadCount = callerPhase ? 1 : std::min<size_t>( mJobs, total );
+    for( size_t i = 1; i < threadCount; ++i )
+      threads.emplace_back( worker );
+    worker();
+    for( auto& t : threads )
+      t.join();
+
+    if( error )
+      std::rethrow_exception( error );
+    if( done < total ) {
+      std::cerr << "cyclic preinit dependencies\n";
+      return false;
+    }
   }
   mPreInitCompleted = true;
+  return true;
 }
 
 
@@ -99,27 +511,49 @@ bool Framework::runAllTests() {
 
   ACATCH_INTERNAL_ASSERT( mPreInitCompleted );
 
-  std::vector<ITestCase*> alltests = mTestRegistry.getAllTests(
-    TestRegistry::RunOrder::InLexicographicalOrder );
-  for( ITestCase* tc : alltests ) {
+  std::vector<ITestCase*> tests;
+  for( ITestCase* tc : getShardTests() ) {
     if( matchFilter( tc->testInfo().name ) ) {
       testCaseInfos.push_back( &tc->testInfo() );
-      runTest( *tc, runResult );
+      tests.push_back( tc );
     } else
       mTestReport->reportTestCaseSkip( tc->testInfo() );
   }
 
+  if( mShardCount > 1 )
+    mTestReport->reportShard( mShardIndex, mShardCount, testCaseInfos );
+
+  for( uint i = 0; i < mRepeat; ++i ) {
+    if( mZygote )
+      Zygote( *this ).run( tests, runResult );
+    else
+      runTests( tests, runResult );
+  }
+
   mTestReport->reportTestRun( testCaseInfos, runResult );
+  mTestReport->reportAssertionSites( AssertionSite::getAll() );
+  if( !mDurationHistoryFile.empty() && !mTestRegistry.getDurationHistory().save( mDurationHistoryFile ) )
+    std::cerr << "failed to save the duration history: " << mDurationHistoryFile << "\n";
   return runResult.getResult();
 }
 
 
+void Framework::runTests( const std::vector<ITestCase*>& aTests, TestRunResult& aRunResult ) {
+  if( mIsolated ) {
+    IsolatedRunner( *this, mJobs ).run( aTests, aRunResult );
+  } else if( mJobs > 1 ) {
+    runTestsParallel( aTests, aRunResult );
+  } else {
+    for( ITestCase* tc : aTests )
+      runTest( mMainContext, *tc, aRunResult );
+  }
+}
+
 /// Report the testcases only without executing them.
 /// The sections are not reported as they cannot be extracted without executing the tests.
 void Framework::reportAllTests() {
   ConstTestCaseInfoRefs testInfos;
-  std::vector<ITestCase*> alltests = mTestRegistry.getAllTests(
-    TestRegistry::RunOrder::InLexicographicalOrder );
+  std::vector<ITestCase*> alltests = getShardTests();
   testInfos.reserve( alltests.size() );
   for( ITestCase* tc : alltests ) {
     if( matchFilter( tc->testInfo().name ) )
@@ -131,28 +565,39 @@ void Framework::reportAllTests() {
 
 
 void Framework::handleLog( const std::string& aMessage ) {
-  if( !aMessage.empty() )
-    mCurrentResult->logMessage( TestCaseResult::Info, aMessage );
+  if( aMessage.empty() )
+    return;
+  if( TestCaseResult* result = context().mCurrentResult )
+    result->logMessage( TestCaseResult::Info, aMessage );
+  else
+    reportOutsideTestCase( "log", aMessage );
 }
 
 
 void Framework::handleSuccess() {
-  mCurrentResult->logSuccess();
+  if( TestCaseResult* result = context().mCurrentResult )
+    result->logSuccess();
 }
 
 
 void Framework::handleSuccess( const std::string& aMessage ) {
-  mCurrentResult->logSuccess();
+  TestCaseResult* result = context().mCurrentResult;
+  if( !result )
+    return;
+  result->logSuccess();
   if( !aMessage.empty() )
-    mCurrentResult->logMessage( TestCaseResult::Info, aMessage );
+    result->logMessage( TestCaseResult::Info, aMessage );
 }
 
 
 void Framework::handleSuccess( const MultiExpressionCapture& aExpr ) {
-  mCurrentResult->logSuccess();
+  TestCaseResult* result = context().mCurrentResult;
+  if( !result )
+    return;
+  result->logSuccess();
   for( const auto & expr : aExpr.getExpressions() ) {
-    mCurrentResult->logMessage( TestCaseResult::Info_ExprRaw, expr.raw );
-    mCurrentResult->logMessage( TestCaseResult::Info_ExprExpanded, expr.expanded );
+    result->logMessage( TestCaseResult::Info_ExprRaw, expr.raw );
+    result->logMessage( TestCaseResult::Info_ExprExpanded, expr.expanded );
   }
 }
 
@@ -161,9 +606,15 @@ void Framework::handleFail( const std::string& aMessage ) {
   if( mBreakOnError >= Break_Fail ) {
     ACATCH_BREAK;
   }
-  mCurrentResult->logFail();
+  TestCaseResult* result = context().mCurrentResult;
+  if( !result ) {
+    reportOutsideTestCase( "failure", aMessage );
+    return;
+  }
+  result->logFail();
+  logCaptures( *result );
   if( !aMessage.empty() )
-    mCurrentResult->logMessage( TestCaseResult::Error, aMessage );
+    result->logMessage( TestCaseResult::Error, aMessage );
 }
 
 
@@ -171,43 +622,88 @@ void Framework::handleFail( const MultiExpressionCapture& aExpr ) {
   if( mBreakOnError >= Break_Fail ) {
     ACATCH_BREAK;
   }
-  mCurrentResult->logFail();
-  for( const auto & expr : aExpr.getExpressions() ) {
-    mCurrentResult->logMessage( TestCaseResult::Error_ExprRaw, expr.raw );
-    mCurrentResult->logMessage( TestCaseResult::Error_ExprExpanded, expr.expanded );
+  TestCaseResult* result = context().mCurrentResult;
+  if( !result ) {
+    reportOutsideTestCase( "failure", aExpr.getValues() );
+    return;
   }
+  result->logFail();
+  logFailure( *result, aExpr );
 }
 
 
 void Framework::handleAbort( const std::string& aMessage ) {
-  if( mCurrentResult->isAborting() ) {
+  TestCaseResult* result = context().mCurrentResult;
+  if( !result ) {
+    // nothing to abort, the thread goes on
+    reportOutsideTestCase( "abort", aMessage );
+    return;
+  }
+  if( result->isAborting() ) {
     // don't throw exceptions recursively during exit from the test
     return;
   }
   if( mBreakOnError >= Break_Abort ) {
     ACATCH_BREAK;
   }
-  mCurrentResult->logAbort();
+  result->logAbort();
+  logCaptures( *result );
   if( !aMessage.empty() )
-    mCurrentResult->logMessage( TestCaseResult::Error, aMessage );
+    result->logMessage( TestCaseResult::Error, aMessage );
   throw TestFailureException();
 }
 
 
 void Framework::handleAbort( const MultiExpressionCapture& aExpr ) {
-  if( mCurrentResult->isAborting() ) {
+  TestCaseResult* result = context().mCurrentResult;
+  if( !result ) {
+    reportOutsideTestCase( "abort", aExpr.getValues() );
+    return;
+  }
+  if( result->isAborting() ) {
     // don't throw exceptions recursively during exit from the test
     return;
   }
   if( mBreakOnError >= Break_Abort ) {
     ACATCH_BREAK;
   }
-  mCurrentResult->logAbort();
+  result->logAbort();
+  logFailure( *result, aExpr );
+  throw TestFailureException();
+}
+
+
+/// A check of a thread that is not running a test case, for example a thread
+/// still running after its test case has ended. It cannot be counted, it is
+/// only printed.
+void Framework::reportOutsideTestCase( const char* aEvent, const std::string& aMessage ) {
+  std::lock_guard<std::timed_mutex> lg( mReportMutex );
+  std::cerr << aEvent << " outside of a test case: " << aMessage << std::endl;
+}
+
+
+/// Log the values captured by ACATCH_CAPTURE in the scope of a failure
+void Framework::logCaptures( TestCaseResult& aResult ) {
+  for( const std::string& capture : ScopedCapture::formatActive() )
+    aResult.logMessage( TestCaseResult::Info, capture );
+}
+
+
+/// Log the failed expressions with the location of the assertion. A site that
+/// has already failed in the result is only counted.
+void Framework::logFailure( TestCaseResult& aResult, const MultiExpressionCapture& aExpr ) {
+  std::string location;
+  if( AssertionSite* site = aExpr.getSite() ) {
+    site->fail( aExpr.getValues() );
+    if( !aResult.logSiteFail( *site ) )
+      return;
+    location = site->location() + ": ";
+  }
+  logCaptures( aResult );
   for( const auto & expr : aExpr.getExpressions() ) {
-    mCurrentResult->logMessage( TestCaseResult::Error_ExprRaw, expr.raw );
-    mCurrentResult->logMessage( TestCaseResult::Error_ExprExpanded, expr.expanded );
+    aResult.logMessage( TestCaseResult::Error_ExprRaw, location + expr.raw );
+    aResult.logMessage( TestCaseResult::Error_ExprExpanded, expr.expanded );
   }
-  throw TestFailureException();
 }
 
 
@@ -215,120 +711,469 @@ void Framework::handleFatalErrorCondition( const std::string& aMessage ) {
   if( mBreakOnError >= Break_Critical ) {
     ACATCH_BREAK;
   }
-  mCurrentResult->logAbort();
-  handleUnfinishedSections();
-  if( !aMessage.empty() )
-    mCurrentResult->logMessage( TestCaseResult::Error, aMessage );
-  reportNow();
+  RunContext& ctx = context();
+  if( TestCaseResult* result = ctx.mCurrentResult ) {
+    result->logAbort();
+    handleUnfinishedSections( ctx );
+    if( !aMessage.empty() )
+      result->logMessage( TestCaseResult::Error, aMessage );
+    ctx.mTestReport->reportFatal( *result );
+  } else {
+    std::cerr << aMessage << std::endl;
+  }
+  if( BufferedTestReport* buffered = dynamic_cast<BufferedTestReport*>( ctx.mTestReport ) ) {
+    // a worker is crashing, its test case is written to the report only under its lock
+    std::unique_lock<std::timed_mutex> lock;
+    if( lockReportForExit( lock ) )
+      buffered->flushTo( *mTestReport );
+    else
+      std::cerr << "the report is busy, the log of the crashed test case is lost: " << aMessage << std::endl;
+  }
+  if( ctx.mForked ) {
+    // the parent reports the end of the test case with the fatal error, and the
+    // state of the parent (threads, static objects) must not be torn down twice
+    std::cout.flush();
+    std::_Exit( -1 );
+  }
   exit( -1 );
   // from signal handle it is not a good thing to throw exceptions (and not possible on some platforms)
   // and as there is no other way to inform the framework of the failure now it's better to exit (and terminate gracefully)
 }
 
 
+/// Lock the report before the process is terminated. The other workers may
+/// hold it while they flush a test case, they are waited for a bounded time:
+/// the terminating thread may be the one holding it. Return false on timeout.
+bool Framework::lockReportForExit( std::unique_lock<std::timed_mutex>& aLock ) {
+  aLock = std::unique_lock<std::timed_mutex>( mReportMutex, std::chrono::seconds( 5 ) );
+  return aLock.owns_lock();
+}
+
+
+/// Called by the watchdog when a test case exceeds its time budget. The test case
+/// cannot be stopped, the partial log is reported and the process is terminated.
+/// Called by the watchdog thread, which keeps the context alive. The state of
+/// the test is read under the watch lock of the context, held until the exit so
+/// that the test thread cannot move on to another section or cycle meanwhile.
+/// During the parallel sections the sections still running are reported.
+void Framework::handleTimeout( RunContext& aContext, const TestCaseInfo& aInfo, double aSeconds ) {
+  std::unique_lock<std::mutex> watchLock( aContext.mWatchMutex );
+  if( aContext.mSectionForker )
+    aContext.mSectionForker->killChild();
+
+  auto describe = [&]( const RunContext& aRunning ) {
+    std::ostringstream ss;
+    ss << "test case timed out after " << aSeconds << " s";
+    if( !aRunning.mActiveSections.empty() || !aRunning.mForkedSections.empty() ) {
+      ss << " in section: ";
+      if( !aRunning.mActiveSections.empty() )
+        ss << aRunning.mActiveSections.back()->getFullName();
+      else
+        ss << aInfo.name;
+      for( const std::string& name : aRunning.mForkedSections )
+        ss << "." << name;
+    } else {
+      ss << ": " << aInfo.name;
+    }
+    return ss.str();
+  };
+
+  // the parallel sections run in contexts of their own, they are held too
+  std::vector<std::unique_lock<std::mutex>> sectionLocks;
+  for( RunContext* section : aContext.mSectionContexts )
+    sectionLocks.emplace_back( section->mWatchMutex );
+
+  std::unique_lock<std::timed_mutex> lock;
+  if( !lockReportForExit( lock ) ) {
+    std::cerr << "the report is busy, the log of the timed out test case is lost: " << describe( aContext ) << std::endl;
+  } else if( TestCaseResult* result = aContext.mCurrentResult ) {
+    result->logAbort();
+    result->logMessage( TestCaseResult::Error, describe( aContext ) );
+    aContext.mTestReport->reportFatal( *result );
+    if( BufferedTestReport* buffered = dynamic_cast<BufferedTestReport*>( aContext.mTestReport ) )
+      buffered->flushTo( *mTestReport );
+  } else if( !aContext.mSectionContexts.empty() ) {
+    // each running section reports where it stands, the reports are merged in
+    // the order of the sections as at the end of the test case
+    bool running = false;
+    for( RunContext* section : aContext.mSectionContexts ) {
+      if( TestCaseResult* result = section->mCurrentResult ) {
+        running = true;
+        result->logAbort();
+        result->logMessage( TestCaseResult::Error, describe( *section ) );
+        section->mTestReport->reportFatal( *result );
+      }
+      if( BufferedTestReport* buffered = dynamic_cast<BufferedTestReport*>( section->mTestReport ) )
+        buffered->flushTo( *aContext.mTestReport );
+    }
+    if( BufferedTestReport* buffered = dynamic_cast<BufferedTestReport*>( aContext.mTestReport ) )
+      buffered->flushTo( *mTestReport );
+    if( !running )
+      std::cerr << describe( aContext ) << std::endl;
+  } else {
+    std::cerr << describe( aContext ) << std::endl;
+  }
+
+  std::cout.flush();
+  std::cerr.flush();
+  std::_Exit( Watchdog::kTimeoutExitCode );
+}
+
+
+/// Report the logs of the current test case. The context of a --jobs worker or
+/// of a parallel section buffers its report, the logs are then reported with
+/// the test case: writing them to the shared report now would interleave them
+/// with the test case being reported by another worker.
 void Framework::reportNow() {
-  mTestReport->reportLogNow( *mCurrentResult );
+  RunContext& ctx = context();
+  if( ctx.mCurrentResult )
+    ctx.mTestReport->reportLogNow( *ctx.mCurrentResult );
 }
 
 
-void Framework::runTest( ITestCase& aTestCase, TestRunResult& aRunResult ) {
-  const TestCaseInfo& testInfo = aTestCase.testInfo();
+/// Checks of the threads not bound to a context while several runners share
+/// the process: the runner that started such a thread cannot be known, so its
+/// checks are collected in a result of their own, reported after the runners.
+struct Framework::UnboundChecks
+{
+  BufferedTestReport report;
+  RunContext context;
+  TestCaseResult result;
+  RunContext* previous; ///< the fallback context replaced by context
 
-  TrackerContext trackerContext;
-  mTrackerContext = &trackerContext;
-  mTestCaseTracker = nullptr;
+  UnboundChecks()
+      : context( &report, false )
+      , previous( nullptr ) {
+  }
+};
 
-  bool aborting = false;
-  bool failed = false;
 
+/// Make aChecks the fallback context, unless the checks of an enclosing
+/// runner are already collected
+void Framework::beginUnboundChecks( UnboundChecks& aChecks ) {
+  if( mUnboundChecks )
+    return;
+  aChecks.context.mCurrentResult = &aChecks.result;
+  aChecks.previous = mFallbackContext.exchange( &aChecks.context, std::memory_order_acq_rel );
+  mUnboundChecks = &aChecks;
+}
+
+
+/// Restore the fallback context and report the collected checks, if any, as a
+/// test case of their own. The runners are done, the unbound threads should be
+/// too.
+void Framework::endUnboundChecks( UnboundChecks& aChecks, ITestReport& aReport, TestRunResult& aRunResult ) {
+  if( mUnboundChecks != &aChecks )
+    return;
+  mFallbackContext.store( aChecks.previous, std::memory_order_release );
+  mUnboundChecks = nullptr;
+
+  TestCaseResult::Logs logs;
+  if( !aChecks.result.takeLogs( logs ) )
+    return;
+  TestCaseResult result;
+  result.restoreCounts( aChecks.result.getFailCount(), aChecks.result.isAborting(),
+                        aChecks.result.getSuccessCount(), true );
+  result.appendLogs( logs );
+  aReport.reportTestCaseStart( unboundChecksInfo() );
+  aReport.reportTestCaseEnd( unboundChecksInfo(), result, Timing() );
+  aRunResult.add( result );
+}
+
+
+/// The test case reporting the checks of the unbound threads
+const TestCaseInfo& Framework::unboundChecksInfo() {
+  static const TestCaseInfo sInfo( "<threads without a run context>" );
+  return sInfo;
+}
+
+
+/// Run the test cases on a pool of worker threads. Each worker owns a run
+/// context and buffers the report of the running test case, that is flushed
+/// to the report of the framework when the test case is completed.
+void Framework::runTestsParallel( const std::vector<ITestCase*>& aTests, TestRunResult& aRunResult ) {
+  const size_t workerCount = std::min<size_t>( mJobs, aTests.size() );
+  std::vector<TestRunResult> workerResults( workerCount );
+  std::atomic<size_t> nextTest( 0 );
+
+  auto worker = [&]( size_t aWorker ) {
+    BufferedTestReport report;
+    RunContext ctx( &report, false );
+    RunContextScope scope( &ctx );
+    for( size_t i = nextTest++; i < aTests.size(); i = nextTest++ ) {
+      runTest( ctx, *aTests[ i ], workerResults[ aWorker ] );
+      std::lock_guard<std::timed_mutex> lg( mReportMutex );
+      report.flushTo( *mTestReport );
+    }
+  };
+
+  // signal handlers are process wide, install them once for all the workers
+  FatalConditionHandler fatalConditionHandler;
+  UnboundChecks unboundChecks;
+  beginUnboundChecks( unboundChecks );
+  std::vector<std::thread> workers;
+  workers.reserve( workerCount );
+  for( size_t i = 0; i < workerCount; ++i )
+    workers.emplace_back( worker, i );
+  for( auto& w : workers )
+    w.join();
+  fatalConditionHandler.reset();
+
+  for( const auto& result : workerResults )
+    aRunResult.add( result );
+  endUnboundChecks( unboundChecks, *mTestReport, aRunResult );
+}
+
+
+void Framework::runTest( RunContext& aContext, ITestCase& aTestCase, TestRunResult& aRunResult ) {
+  RunContextScope scope( &aContext );
+  TrackerContext trackerContext;
+
+  auto start = std::chrono::steady_clock::now();
+  double timeout = getTimeout( aTestCase.testInfo() );
+  WatchdogScope watchdogScope( mWatchdog, aContext, aTestCase.testInfo(), timeout );
   aTestCase.setUp();
 
   trackerContext.startRun();
+  if( aTestCase.testInfo().hasFlag( TestCaseInfo::ParallelSections ) && aTestCase.isReentrant() ) {
+    runSectionsParallel( aContext, aTestCase, trackerContext, aRunResult );
+  } else {
+    // forking is safe only when the runner is alone in its process, that is when
+    // its context owns the signal handlers
+    if( ( mForkSections || aTestCase.testInfo().hasFlag( TestCaseInfo::ForkSections ) )
+        && aContext.mGuardSignals && SectionForker::isSupported() )
+      aContext.mSectionForker.reset( new SectionForker( timeout ) );
+    runTestCycles( aContext, aTestCase, trackerContext, aRunResult, false );
+    aContext.mSectionForker.reset();
+  }
+
+  aTestCase.tearDown();
+  recordDuration( aTestCase.testInfo(),
+                  std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count() );
+}
+
+
+/// Execute the cycles of a test case until all the sections are completed or
+/// the test is aborted. Returns true if the test case was aborted.
+bool Framework::runTestCycles( RunContext& aContext, ITestCase& aTestCase, TrackerContext& aTrackerContext,
+                               TestRunResult& aRunResult, bool aSingleCycle ) {
+  const TestCaseInfo& testInfo = aTestCase.testInfo();
+
+  aContext.mTrackerContext = &aTrackerContext;
+  aContext.mTestCaseTracker = nullptr;
+
+  bool aborting = false;
+  bool completed = false;
   do {
-    TestCaseResult testResult;
-    mCurrentResult = &testResult;
-    trackerContext.startCycle();
-    SectionAcquired sectionTracker = SectionTracker::acquire( trackerContext, testInfo.name );
-    mTestCaseTracker = sectionTracker.first;
-    runTestGuarded( aTestCase );
+    // the previous cycle is reported, its logs are released at once
+    aContext.mLogArena.reset();
+    TestCaseResult testResult( &aContext.mLogArena );
+    {
+      std::lock_guard<std::mutex> lg( aContext.mWatchMutex );
+      aContext.mCurrentResult = &testResult;
+    }
+    aTrackerContext.startCycle();
+    SectionAcquired sectionTracker = SectionTracker::acquire( aTrackerContext, testInfo.name );
+    aContext.mTestCaseTracker = sectionTracker.first;
+    runTestGuarded( aContext, aTestCase );
+    if( aContext.mSectionForker && aContext.mSectionForker->isForked() )
+      aContext.mSectionForker->exitForked(); // its results are merged by the parent
     aRunResult.add( testResult );
-    failed |= testResult.isFailed();
     aborting |= testResult.isAborting();
-    mCurrentResult = nullptr;
-  } while( !mTestCaseTracker->isSuccessfullyCompleted() && !aborting );
+    {
+      std::lock_guard<std::mutex> lg( aContext.mWatchMutex );
+      aContext.mCurrentResult = nullptr;
+    }
+    completed = aContext.mTestCaseTracker->isSuccessfullyCompleted()
+                || ( aContext.mSectionPathTracker && aContext.mSectionPathTracker->isComplete() );
+  } while( !completed && !aborting && !aSingleCycle );
+
+  aContext.mTestCaseTracker = nullptr;
+  aContext.mTrackerContext = nullptr;
+  aContext.mSectionPathTracker = nullptr;
+  return aborting;
+}
 
-  aTestCase.tearDown();
 
-  mTestCaseTracker = nullptr;
-  mTrackerContext = nullptr;
+/// Execute the top level sections of a test case concurrently. The first cycle
+/// discovers the sections, then the sections not yet completed are pulled by a
+/// pool of --jobs threads (one per hardware thread without --jobs), each one
+/// with its own tracker and run context. The reports and the results are
+/// merged in the order of the sections.
+void Framework::runSectionsParallel( RunContext& aContext, ITestCase& aTestCase, TrackerContext& aTrackerContext,
+                                     TestRunResult& aRunResult ) {
+  if( runTestCycles( aContext, aTestCase, aTrackerContext, aRunResult, true ) )
+    return;
+
+  ITracker* testCaseTracker = aTrackerContext.rootTracker().findChild( aTestCase.testInfo().name );
+  if( !testCaseTracker || testCaseTracker->isComplete() )
+    return;
+
+  struct SectionRun {
+    SectionRun()
+        : context( &report, false ) {
+    }
+
+    std::vector<std::string> path;
+    bool continueDiscovery; ///< the section was entered by the first cycle, continue with its tracker
+    BufferedTestReport report;
+    RunContext context;
+    TestRunResult result;
+  };
+
+  std::vector<std::unique_ptr<SectionRun>> runs;
+  for( size_t i = 0; i < testCaseTracker->childCount(); ++i ) {
+    ITracker* section = testCaseTracker->childAt( i );
+    if( section->isComplete() )
+      continue;
+    runs.emplace_back( new SectionRun() );
+    runs.back()->path = getSectionPath( *section );
+    runs.back()->continueDiscovery = section->isOpen();
+    runs.back()->context.mSectionPath = runs.back()->path;
+  }
+
+  auto runSection = [&]( SectionRun& aRun ) {
+    RunContext& ctx = aRun.context;
+    RunContextScope scope( &ctx );
+    if( aRun.continueDiscovery ) {
+      runTestCycles( ctx, aTestCase, aTrackerContext, aRun.result, false );
+    } else {
+      TrackerContext trackerContext;
+      trackerContext.startRun();
+      runTestCycles( ctx, aTestCase, trackerContext, aRun.result, false );
+    }
+  };
+
+  // the watchdog of the test case reports the sections still running
+  {
+    std::lock_guard<std::mutex> lg( aContext.mWatchMutex );
+    for( auto& run : runs )
+      aContext.mSectionContexts.push_back( &run->context );
+  }
+
+  // signal handlers are process wide, install them once for all the threads
+  std::unique_ptr<FatalConditionHandler> fatalConditionHandler;
+  if( aContext.mGuardSignals )
+    fatalConditionHandler.reset( new FatalConditionHandler() );
+  UnboundChecks unboundChecks;
+  beginUnboundChecks( unboundChecks );
+  std::atomic<size_t> next( 0 );
+  auto worker = [&]() {
+    for( size_t i = next++; i < runs.size(); i = next++ )
+      runSection( *runs[ i ] );
+  };
+  const size_t threadCount = std::min<size_t>(
+      runs.size(), mJobs > 1 ? mJobs : std::max( 1u, std::thread::hardware_concurrency() ) );
+  std::vector<std::thread> threads;
+  for( size_t i = 1; i < threadCount; ++i )
+    threads.emplace_back( worker );
+  worker();
+  for( auto& t : threads )
+    t.join();
+  fatalConditionHandler.reset();
+  {
+    std::lock_guard<std::mutex> lg( aContext.mWatchMutex );
+    aContext.mSectionContexts.clear();
+  }
+
+  for( auto& run : runs ) {
+    run->report.flushTo( *aContext.mTestReport );
+    aRunResult.add( run->result );
+  }
+  endUnboundChecks( unboundChecks, *aContext.mTestReport, aRunResult );
 }
 
 
 bool Framework::isAborting() const {
-  ACATCH_INTERNAL_ASSERT( mCurrentResult );
-  return mCurrentResult->isAborting();
+  const TestCaseResult* result = context().mCurrentResult;
+  return result && result->isAborting();
 }
 
 
 bool Framework::isFailed() const {
-  ACATCH_INTERNAL_ASSERT( mCurrentResult );
-  return mCurrentResult->isFailed();
+  const TestCaseResult* result = context().mCurrentResult;
+  return result && result->isFailed();
+}
+
+
+/// Indicates if the assertion site has already failed in the current result
+bool Framework::isRepeatedFailure( const AssertionSite& aSite ) const {
+  TestCaseResult* result = context().mCurrentResult;
+  return result && result->hasSiteFailed( aSite );
 }
 
 
 bool Framework::isRunning() const {
-  return !!mCurrentResult;
+  return !!context().mCurrentResult;
 }
 
 
 bool Framework::isInAssertTest() const {
-  return mInAssertTest;
+  return context().mInAssertTest;
 }
 
 
-void Framework::runTestGuarded( ITestCase& aActiveTestCase ) {
-  mTestReport->reportTestCaseStart( aActiveTestCase.testInfo() );
+void Framework::runTestGuarded( RunContext& aContext, ITestCase& aActiveTestCase ) {
+  aContext.mTestReport->reportTestCaseStart( aActiveTestCase.testInfo() );
+  Timer timer;
+  timer.start();
   try {
-    // Timer timer;
-    // timer.start();
-    FatalConditionHandler fatalConditionHandler; // Handle signals
-    aActiveTestCase.invoke();
-    fatalConditionHandler.reset();
-    // duration = timer.getElapsedSeconds();
+    if( !aContext.mGuardSignals ) {
+      // signals are handled by the owner of the thread
+      aActiveTestCase.invoke();
+    } else {
+      FatalConditionHandler fatalConditionHandler; // Handle signals
+      aActiveTestCase.invoke();
+      fatalConditionHandler.reset();
+    }
   } catch( TestFailureException ) {
     // This just means the test was aborted due to failure
   } catch( ... ) {
-    mCurrentResult->logFail();
+    aContext.mCurrentResult->logFail();
     // mCurrentResult->logMessage( exception translater );
   }
 
-  mTestCaseTracker->close();
-  handleUnfinishedSections();
+  Timing timing = timer.getElapsed();
+  aContext.mTestCaseTracker->close();
+  handleUnfinishedSections( aContext );
 
-  mTestReport->reportTestCaseEnd( aActiveTestCase.testInfo(), *mCurrentResult );
+  aContext.mTestReport->reportTestCaseEnd( aActiveTestCase.testInfo(), *aContext.mCurrentResult, timing );
 }
 
 
-void Framework::handleUnfinishedSections() {
+void Framework::handleUnfinishedSections( RunContext& aContext ) {
   // If sections ended prematurely due to an exception we stored their
   // infos here so we can tear them down outside the unwind process.
-  for( std::vector<SectionInfo>::const_reverse_iterator
-       it = mUnfinishedSections.rbegin(),
-       itEnd = mUnfinishedSections.rend();
+  for( auto it = aContext.mUnfinishedSections.rbegin(),
+       itEnd = aContext.mUnfinishedSections.rend();
        it != itEnd; ++it ) {
-    sectionEnded( *it );
+    sectionEnded( it->first, it->second );
   }
-  mUnfinishedSections.clear();
+  aContext.mUnfinishedSections.clear();
 }
 
 
 bool Framework::sectionStarted( const SectionInfo& aSectionInfo ) {
-  SectionAcquired sectionTracker = SectionTracker::acquire( *mTrackerContext, aSectionInfo.name );
+  RunContext& ctx = context();
+  if( !ctx.mTrackerContext )
+    return false; // not in a test case
+  SectionAcquired sectionTracker = SectionTracker::acquire( *ctx.mTrackerContext, aSectionInfo.name );
+
+  if( sectionTracker.first->isOpen() && !ctx.mSectionPath.empty() ) {
+    // sections of the other paths are executed by other threads, skip them silently
+    std::vector<std::string> path = getSectionPath( *sectionTracker.first );
+    if( !isOnSectionPath( ctx.mSectionPath, path ) ) {
+      sectionTracker.first->skip();
+      return false;
+    }
+    if( path == ctx.mSectionPath )
+      ctx.mSectionPathTracker = sectionTracker.first;
+  }
 
   if( sectionTracker.first->isOpen() && !mPatterns.empty() ) {
     std::string name = sectionTracker.first->getFullName();
     if( !matchFilter( name ) ) {
-      mTestReport->reportTestSectionSkip( aSectionInfo );
+      ctx.mTestReport->reportTestSectionSkip( aSectionInfo );
       sectionTracker.first->skip();
       return false;
     }
@@ -337,30 +1182,47 @@ bool Framework::sectionStarted( const SectionInfo& aSectionInfo ) {
   if( !sectionTracker.first->isOpen() )
     return false;
 
-  mActiveSections.push_back( sectionTracker.first );
-  mTestReport->reportTestSectionStart( aSectionInfo );
+  if( sectionTracker.second && ctx.mSectionForker && !ctx.mSectionForker->fork( ctx ) ) {
+    // executed by the forked process, go on with the next sections in this cycle
+    sectionTracker.first->closeForked();
+    if( ctx.mCurrentResult->isAborting() )
+      throw TestFailureException();
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lg( ctx.mWatchMutex );
+    ctx.mActiveSections.push_back( sectionTracker.first );
+  }
+  ctx.mTestReport->reportTestSectionStart( aSectionInfo );
   return true;
 }
 
 
-void Framework::sectionEnded( const SectionInfo& aSectionInfo ) {
-  if( !mActiveSections.empty() ) {
-    mActiveSections.back()->close();
-    mActiveSections.pop_back();
+void Framework::sectionEnded( const SectionInfo& aSectionInfo, const Timing& aTiming ) {
+  RunContext& ctx = context();
+  if( !ctx.mActiveSections.empty() ) {
+    ctx.mActiveSections.back()->close();
+    std::lock_guard<std::mutex> lg( ctx.mWatchMutex );
+    ctx.mActiveSections.pop_back();
   }
 
-  mTestReport->reportTestSectionEnd( aSectionInfo, *mCurrentResult );
+  ctx.mTestReport->reportTestSectionEnd( aSectionInfo, *ctx.mCurrentResult, aTiming );
 }
 
 
-void Framework::sectionEndedEarly( const SectionInfo& aSectionInfo ) {
-  if( mUnfinishedSections.empty() ) {
-    mActiveSections.back()->fail();
+void Framework::sectionEndedEarly( const SectionInfo& aSectionInfo, const Timing& aTiming ) {
+  RunContext& ctx = context();
+  if( ctx.mUnfinishedSections.empty() ) {
+    ctx.mActiveSections.back()->fail();
   } else
-    mActiveSections.back()->close();
+    ctx.mActiveSections.back()->close();
 
-  mActiveSections.pop_back();
-  mUnfinishedSections.push_back( aSectionInfo );
+  {
+    std::lock_guard<std::mutex> lg( ctx.mWatchMutex );
+    ctx.mActiveSections.pop_back();
+  }
+  ctx.mUnfinishedSections.emplace_back( aSectionInfo, aTiming );
 }
 
 
@@ -379,4 +1241,44 @@ ACATCH_API void fatal( const std::string& aMessage ) {
 }
 
 
+ACATCH_API bool isRepeatedFailure( const AssertionSite& aSite ) {
+  return theACatch().isRepeatedFailure( aSite );
+}
+
+
+ACATCH_API void handleLog( const std::string& aMessage ) {
+  theACatch().handleLog( aMessage );
+}
+
+
+ACATCH_API void handleSuccess() {
+  theACatch().handleSuccess();
+}
+
+
+ACATCH_API void handleSuccess( const MultiExpressionCapture& aExpr ) {
+  theACatch().handleSuccess( aExpr );
+}
+
+
+ACATCH_API void handleFail( const std::string& aMessage ) {
+  theACatch().handleFail( aMessage );
+}
+
+
+ACATCH_API void handleFail( const MultiExpressionCapture& aExpr ) {
+  theACatch().handleFail( aExpr );
+}
+
+
+ACATCH_API void handleAbort( const std::string& aMessage ) {
+  theACatch().handleAbort( aMessage );
+}
+
+
+ACATCH_API void handleAbort( const MultiExpressionCapture& aExpr ) {
+  theACatch().handleAbort( aExpr );
+}
+
+
 } // namespace ACatch
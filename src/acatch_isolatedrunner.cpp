@@ -0,0 +1,1114 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#  define ACATCH_INTERNAL_HAS_FORK
+#endif
+
+#ifdef ACATCH_INTERNAL_HAS_FORK
+#  include <cerrno>
+#  include <chrono>
+#  include <csignal>
+#  include <cstdint>
+#  include <cstdio>
+#  include <cstring>
+#  include <poll.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+namespace ACatch {
+
+#ifdef ACATCH_INTERNAL_HAS_FORK
+
+namespace {
+
+/// Messages sent by the workers. Each message is framed as
+/// [type:1][payload size:4][payload].
+enum class EMessage : unsigned char {
+  TestCaseStart,
+  TestSectionStart,
+  TestSectionSkip,
+  TestSectionEnd,
+  TestCaseEnd,
+  LogNow,
+  Fatal,
+  Done,
+  RunResult,
+  Sites,
+};
+
+/// Test index sent to a worker to make it quit
+const uint32_t kQuitWorker = 0xffffffff;
+const size_t kHeaderSize = 5;
+
+bool writeAll( int aFd, const void* aData, size_t aSize ) {
+  const char* data = static_cast<const char*>( aData );
+  while( aSize > 0 ) {
+    ssize_t n = ::write( aFd, data, aSize );
+    if( n < 0 ) {
+      if( errno == EINTR )
+        continue;
+      return false;
+    }
+    data += n;
+    aSize -= static_cast<size_t>( n );
+  }
+  return true;
+}
+
+bool readAll( int aFd, void* aData, size_t aSize ) {
+  char* data = static_cast<char*>( aData );
+  while( aSize > 0 ) {
+    ssize_t n = ::read( aFd, data, aSize );
+    if( n < 0 && errno == EINTR )
+      continue;
+    if( n <= 0 )
+      return false;
+    data += n;
+    aSize -= static_cast<size_t>( n );
+  }
+  return true;
+}
+
+/// Encode a message of a worker
+class MessageWriter {
+public:
+  MessageWriter( EMessage aType )
+      : mBuffer( kHeaderSize, '\0' ) {
+    mBuffer[ 0 ] = static_cast<char>( aType );
+  }
+
+  MessageWriter& add( uint32_t aValue ) {
+    mBuffer.append( reinterpret_cast<const char*>( &aValue ), sizeof( aValue ) );
+    return *this;
+  }
+
+  MessageWriter& add( uint64_t aValue ) {
+    mBuffer.append( reinterpret_cast<const char*>( &aValue ), sizeof( aValue ) );
+    return *this;
+  }
+
+  MessageWriter& add( double aValue ) {
+    mBuffer.append( reinterpret_cast<const char*>( &aValue ), sizeof( aValue ) );
+    return *this;
+  }
+
+  MessageWriter& add( const Timing& aTiming ) {
+    add( aTiming.wallSeconds );
+    add( aTiming.cpuSeconds );
+    return *this;
+  }
+
+  MessageWriter& add( const StringRef& aValue ) {
+    add( static_cast<uint32_t>( aValue.size() ) );
+    mBuffer.append( aValue.data(), aValue.size() );
+    return *this;
+  }
+
+  MessageWriter& add( TestCaseResult& aResult ) {
+    TestCaseResult::Logs logs;
+    bool hasNew = aResult.takeLogs( logs );
+    add( aResult.getFailCount() );
+    add( static_cast<uint32_t>( aResult.isAborting() ) );
+    add( aResult.getSuccessCount() );
+    add( static_cast<uint32_t>( hasNew ) );
+    add( static_cast<uint32_t>( logs.size() ) );
+    for( const auto& l : logs ) {
+      add( static_cast<uint32_t>( l.first ) );
+      add( l.second );
+    }
+    return *this;
+  }
+
+  bool send( int aFd ) {
+    uint32_t size = static_cast<uint32_t>( mBuffer.size() - kHeaderSize );
+    memcpy( &mBuffer[ 1 ], &size, sizeof( size ) );
+    return writeAll( aFd, mBuffer.data(), mBuffer.size() );
+  }
+
+private:
+  std::string mBuffer;
+};
+
+/// Decode the payload of a message
+class MessageReader {
+public:
+  MessageReader( const char* aData, size_t aSize )
+      : mData( aData )
+      , mSize( aSize )
+      , mPos( 0 ) {
+  }
+
+  bool atEnd() const {
+    return mPos >= mSize;
+  }
+
+  uint32_t getUint() {
+    uint32_t value = 0;
+    ACATCH_INTERNAL_ASSERT( mPos + sizeof( value ) <= mSize );
+    memcpy( &value, mData + mPos, sizeof( value ) );
+    mPos += sizeof( value );
+    return value;
+  }
+
+  uint64_t getUint64() {
+    uint64_t value = 0;
+    ACATCH_INTERNAL_ASSERT( mPos + sizeof( value ) <= mSize );
+    memcpy( &value, mData + mPos, sizeof( value ) );
+    mPos += sizeof( value );
+    return value;
+  }
+
+  double getDouble() {
+    double value = 0;
+    ACATCH_INTERNAL_ASSERT( mPos + sizeof( value ) <= mSize );
+    memcpy( &value, mData + mPos, sizeof( value ) );
+    mPos += sizeof( value );
+    return value;
+  }
+
+  Timing getTiming() {
+    Timing timing;
+    timing.wallSeconds = getDouble();
+    timing.cpuSeconds = getDouble();
+    return timing;
+  }
+
+  std::string getString() {
+    uint32_t size = getUint();
+    ACATCH_INTERNAL_ASSERT( mPos + size <= mSize );
+    std::string value( mData + mPos, size );
+    mPos += size;
+    return value;
+  }
+
+  void getResult( TestCaseResult& aResult ) {
+    uint64_t failCount = getUint64();
+    bool aborting = getUint() != 0;
+    uint64_t successCount = getUint64();
+    bool hasNew = getUint() != 0;
+    aResult.restoreCounts( failCount, aborting, successCount, hasNew );
+    // the logs were retained by the sender, they are appended as they are
+    std::vector<std::pair<TestCaseResult::ELog, std::string>> messages( getUint() );
+    for( auto& message : messages ) {
+      message.first = static_cast<TestCaseResult::ELog>( getUint() );
+      message.second = getString();
+    }
+    TestCaseResult::Logs logs;
+    for( const auto& message : messages )
+      logs.emplace_back( message.first, message.second );
+    aResult.appendLogs( logs );
+  }
+
+private:
+  const char* mData;
+  size_t mSize;
+  size_t mPos;
+};
+
+/// Report of a worker process, the events are streamed to the parent as they happen
+/// so the log of a crashing test case is not lost.
+class PipeTestReport
+    : public ITestReport
+{
+public:
+  PipeTestReport( int aFd )
+      : mFd( aFd ) {
+  }
+
+  virtual void setProperty( const std::string&, const std::string& ) override {
+  }
+
+  virtual void reportTestCases( const ConstTestCaseInfoRefs& ) override {
+  }
+
+  virtual void reportShard( uint, uint, const ConstTestCaseInfoRefs& ) override {
+  }
+
+  virtual void reportTestCaseSkip( const TestCaseInfo& ) override {
+  }
+
+  virtual void reportTestCaseStart( const TestCaseInfo& aInfo ) override {
+    send( MessageWriter( EMessage::TestCaseStart ).add( aInfo.name ) );
+  }
+
+  virtual void reportTestSectionStart( const SectionInfo& aInfo ) override {
+    send( MessageWriter( EMessage::TestSectionStart ).add( aInfo.name ) );
+  }
+
+  virtual void reportTestSectionSkip( const SectionInfo& aInfo ) override {
+    send( MessageWriter( EMessage::TestSectionSkip ).add( aInfo.name ) );
+  }
+
+  virtual void reportTestSectionEnd( const SectionInfo& aInfo, TestCaseResult& aResult, const Timing& aTiming ) override {
+    send( MessageWriter( EMessage::TestSectionEnd ).add( aInfo.name ).add( aTiming ).add( aResult ) );
+  }
+
+  virtual void reportTestCaseEnd( const TestCaseInfo&, TestCaseResult& aResult, const Timing& aTiming ) override {
+    send( MessageWriter( EMessage::TestCaseEnd ).add( aTiming ).add( aResult ) );
+  }
+
+  virtual void reportLogNow( TestCaseResult& aResult ) override {
+    send( MessageWriter( EMessage::LogNow ).add( aResult ) );
+  }
+
+  /// The result is reported by the parent when the process has ended
+  virtual void reportFatal( TestCaseResult& aResult ) override {
+    send( MessageWriter( EMessage::Fatal ).add( aResult ) );
+  }
+
+  virtual void reportTestRun( const ConstTestCaseInfoRefs&, TestRunResult& ) override {
+  }
+
+  virtual void reportAssertionSites( const std::vector<const AssertionSite*>& ) override {
+  }
+
+  void send( MessageWriter& aMessage ) {
+    if( !aMessage.send( mFd ) )
+      _exit( 1 ); // the parent is gone
+  }
+
+  void send( MessageWriter&& aMessage ) {
+    send( aMessage );
+  }
+
+private:
+  int mFd;
+};
+
+/// Time given to a worker to report its own timeout before it is killed
+const double kTimeoutGraceSeconds = 5;
+
+std::string describeExit( const char* aProcess, int aStatus, bool aKilled ) {
+  std::ostringstream ss;
+  ss << aProcess;
+  if( aKilled || ( WIFEXITED( aStatus ) && WEXITSTATUS( aStatus ) == Watchdog::kTimeoutExitCode ) )
+    ss << " process timed out";
+  else if( WIFSIGNALED( aStatus ) )
+    ss << " process crashed: " << strsignal( WTERMSIG( aStatus ) );
+  else if( WIFEXITED( aStatus ) )
+    ss << " process exited with code " << WEXITSTATUS( aStatus );
+  else
+    ss << " process terminated";
+  return ss.str();
+}
+
+/// Counts of an assertion site when a forked run starts
+struct SiteCounts {
+  uint64_t hits;
+  uint64_t fails;
+  bool reached;
+  bool failed;
+};
+
+std::map<const AssertionSite*, SiteCounts> getSiteCounts() {
+  std::map<const AssertionSite*, SiteCounts> counts;
+  for( const AssertionSite* site : AssertionSite::getAll() )
+    counts[ site ] = SiteCounts{ site->getHits(), site->getFails(), site->isReached(), site->getFails() > 0 };
+  return counts;
+}
+
+/// Message of the sites reached by a forked run: [site][hits][fails][first failure set][first failure].
+/// The addresses of the sites are the same in the parent.
+MessageWriter siteMessage( const std::map<const AssertionSite*, SiteCounts>& aStart ) {
+  MessageWriter message( EMessage::Sites );
+  for( const AssertionSite* site : AssertionSite::getAll() ) {
+    if( !site->isReached() )
+      continue;
+    SiteCounts start = SiteCounts{ 0, 0, false, false };
+    auto it = aStart.find( site );
+    if( it != aStart.end() )
+      start = it->second;
+    const bool failed = !start.failed && site->getFails() > 0;
+    if( start.reached && site->getHits() == start.hits && site->getFails() == start.fails )
+      continue;
+    message.add( static_cast<uint64_t>( reinterpret_cast<uintptr_t>( site ) ) );
+    message.add( site->getHits() - start.hits );
+    message.add( site->getFails() - start.fails );
+    message.add( static_cast<uint32_t>( failed ) );
+    message.add( failed ? site->getFirstFailure() : std::string() );
+  }
+  return message;
+}
+
+/// Extract the next complete message of a buffer, advancing aPos past it
+bool nextMessage( const std::string& aInput, size_t& aPos, EMessage& aType, MessageReader& aReader ) {
+  if( aInput.size() - aPos < kHeaderSize )
+    return false;
+  uint32_t size;
+  memcpy( &size, aInput.data() + aPos + 1, sizeof( size ) );
+  if( aInput.size() - aPos - kHeaderSize < size )
+    return false;
+  aType = static_cast<EMessage>( aInput[ aPos ] );
+  aReader = MessageReader( aInput.data() + aPos + kHeaderSize, size );
+  aPos += kHeaderSize + size;
+  return true;
+}
+
+} // namespace
+
+
+struct IsolatedRunner::Worker {
+  pid_t pid;
+  int toWorker;
+  int fromWorker;
+  int testIndex;        ///< the running test, -1 if idle
+  bool testStarted;     ///< a test cycle has started and not yet ended
+  bool killed;          ///< killed by the parent after exceeding the time budget
+  std::vector<SectionInfo> openSections;
+  std::string input;    ///< received but not yet processed data
+  BufferedTestReport report;
+  std::unique_ptr<TestCaseResult> fatalResult; ///< result of a test case ended by a fatal error of the worker
+  std::chrono::steady_clock::time_point testStart;
+
+  Worker()
+      : pid( -1 )
+      , toWorker( -1 )
+      , fromWorker( -1 )
+      , testIndex( -1 )
+      , testStarted( false )
+      , killed( false ) {
+  }
+
+  bool isAlive() const {
+    return pid > 0;
+  }
+};
+
+
+IsolatedRunner::IsolatedRunner( Framework& aFramework, uint aWorkerCount, ITestReport* aTestReport )
+    : mFramework( aFramework )
+    , mTestReport( aTestReport ? aTestReport : aFramework.getTestReport() )
+    , mWorkerCount( std::max( 1u, aWorkerCount ) )
+    , mTests( nullptr )
+    , mNextTest( 0 ) {
+}
+
+
+IsolatedRunner::~IsolatedRunner() {
+}
+
+
+void IsolatedRunner::run( const std::vector<ITestCase*>& aTests, TestRunResult& aRunResult ) {
+  mTests = &aTests;
+  mNextTest = 0;
+
+  // a dead worker shall not kill the parent
+  void ( *prevSigPipe )( int ) = signal( SIGPIPE, SIG_IGN );
+
+  const size_t workerCount = std::min<size_t>( mWorkerCount, aTests.size() );
+  for( size_t i = 0; i < workerCount; ++i ) {
+    mWorkers.emplace_back( new Worker() );
+    if( spawnWorker( *mWorkers.back() ) )
+      assignNextTest( *mWorkers.back() );
+  }
+
+  std::vector<pollfd> fds;
+  std::vector<Worker*> polled;
+  std::vector<char> buffer( 64 * 1024 );
+  for( ;; ) {
+    fds.clear();
+    polled.clear();
+    for( auto& w : mWorkers ) {
+      if( w->isAlive() ) {
+        fds.push_back( pollfd{ w->fromWorker, POLLIN, 0 } );
+        polled.push_back( w.get() );
+      }
+    }
+    if( fds.empty() )
+      break;
+
+    if( poll( fds.data(), fds.size(), killOverdueWorkers() ) < 0 ) {
+      if( errno == EINTR )
+        continue;
+      fatal( "poll failed in the isolated runner" );
+    }
+
+    for( size_t i = 0; i < fds.size(); ++i ) {
+      if( fds[ i ].revents == 0 )
+        continue;
+      Worker& worker = *polled[ i ];
+      ssize_t n = ::read( worker.fromWorker, buffer.data(), buffer.size() );
+      if( n > 0 ) {
+        worker.input.append( buffer.data(), static_cast<size_t>( n ) );
+        processMessages( worker, aRunResult );
+      } else if( n == 0 || errno != EINTR ) {
+        handleWorkerExit( worker, aRunResult );
+      }
+    }
+  }
+
+  mWorkers.clear();
+  signal( SIGPIPE, prevSigPipe );
+}
+
+
+bool IsolatedRunner::spawnWorker( Worker& aWorker ) {
+  int toWorker[ 2 ];
+  int fromWorker[ 2 ];
+  if( pipe( toWorker ) != 0 )
+    return false;
+  if( pipe( fromWorker ) != 0 ) {
+    close( toWorker[ 0 ] );
+    close( toWorker[ 1 ] );
+    return false;
+  }
+
+  // don't let the child print the pending output of the parent again
+  std::cout.flush();
+  fflush( nullptr );
+
+  pid_t pid = fork();
+  if( pid == 0 ) {
+    close( toWorker[ 1 ] );
+    close( fromWorker[ 0 ] );
+    for( auto& w : mWorkers ) {
+      if( w->isAlive() ) {
+        close( w->toWorker );
+        close( w->fromWorker );
+      }
+    }
+    workerMain( toWorker[ 0 ], fromWorker[ 1 ] );
+    // never returns
+  }
+
+  close( toWorker[ 0 ] );
+  close( fromWorker[ 1 ] );
+  if( pid < 0 ) {
+    close( toWorker[ 1 ] );
+    close( fromWorker[ 0 ] );
+    return false;
+  }
+
+  aWorker.pid = pid;
+  aWorker.toWorker = toWorker[ 1 ];
+  aWorker.fromWorker = fromWorker[ 0 ];
+  aWorker.testIndex = -1;
+  aWorker.testStarted = false;
+  aWorker.killed = false;
+  aWorker.openSections.clear();
+  aWorker.input.clear();
+  aWorker.fatalResult.reset();
+  return true;
+}
+
+
+/// Main loop of a worker process: run the test cases requested by the parent
+void IsolatedRunner::workerMain( int aInput, int aOutput ) {
+  PipeTestReport report( aOutput );
+  RunContext ctx( &report );
+  ctx.mForked = true;
+  RunContextScope scope( &ctx );
+  TestRunResult runResult; // the parent collects the results from the reports
+
+  // the worker runs one test case at a time, the threads started by the test
+  // cases fall back to its context
+  mFramework.mFallbackContext.store( &ctx );
+  mFramework.mUnboundChecks = nullptr;
+
+  uint32_t index;
+  while( readAll( aInput, &index, sizeof( index ) ) && index != kQuitWorker ) {
+    mFramework.runTest( ctx, *( *mTests )[ index ], runResult );
+    report.send( MessageWriter( EMessage::Done ) );
+  }
+
+  std::cout.flush();
+  fflush( nullptr );
+  _exit( 0 );
+}
+
+
+void IsolatedRunner::assignNextTest( Worker& aWorker ) {
+  uint32_t index = kQuitWorker;
+  if( mNextTest < mTests->size() ) {
+    aWorker.testIndex = static_cast<int>( mNextTest++ );
+    aWorker.testStart = std::chrono::steady_clock::now();
+    index = static_cast<uint32_t>( aWorker.testIndex );
+  } else {
+    aWorker.testIndex = -1;
+  }
+  // on failure the worker is dead, it is handled when its pipe is closed
+  writeAll( aWorker.toWorker, &index, sizeof( index ) );
+}
+
+
+void IsolatedRunner::processMessages( Worker& aWorker, TestRunResult& aRunResult ) {
+  size_t pos = 0;
+  EMessage type;
+  MessageReader reader( nullptr, 0 );
+  while( nextMessage( aWorker.input, pos, type, reader ) ) {
+    ACATCH_INTERNAL_ASSERT( aWorker.testIndex >= 0 );
+    const TestCaseInfo& testInfo = ( *mTests )[ aWorker.testIndex ]->testInfo();
+    switch( type ) {
+    case EMessage::TestCaseStart:
+      aWorker.testStarted = true;
+      aWorker.openSections.clear();
+      aWorker.report.reportTestCaseStart( testInfo );
+      break;
+
+    case EMessage::TestSectionStart:
+      aWorker.openSections.emplace_back( reader.getString() );
+      aWorker.report.reportTestSectionStart( aWorker.openSections.back() );
+      break;
+
+    case EMessage::TestSectionSkip:
+      aWorker.report.reportTestSectionSkip( SectionInfo( reader.getString() ) );
+      break;
+
+    case EMessage::TestSectionEnd: {
+      SectionInfo info( reader.getString() );
+      Timing timing = reader.getTiming();
+      TestCaseResult result;
+      reader.getResult( result );
+      if( !aWorker.openSections.empty() )
+        aWorker.openSections.pop_back();
+      aWorker.report.reportTestSectionEnd( info, result, timing );
+    } break;
+
+    case EMessage::TestCaseEnd: {
+      Timing timing = reader.getTiming();
+      TestCaseResult result;
+      reader.getResult( result );
+      aRunResult.add( result );
+      aWorker.testStarted = false;
+      aWorker.report.reportTestCaseEnd( testInfo, result, timing );
+    } break;
+
+    case EMessage::LogNow: {
+      TestCaseResult result;
+      reader.getResult( result );
+      aWorker.report.reportLogNow( result );
+    } break;
+
+    case EMessage::Fatal:
+      aWorker.fatalResult.reset( new TestCaseResult() );
+      reader.getResult( *aWorker.fatalResult );
+      break;
+
+    case EMessage::Done:
+      recordDuration( aWorker );
+      aWorker.report.flushTo( *mTestReport );
+      assignNextTest( aWorker );
+      break;
+
+    case EMessage::RunResult:
+    case EMessage::Sites:
+      break;
+    }
+  }
+  aWorker.input.erase( 0, pos );
+}
+
+
+/// The pipe of a worker was closed: reap the process and if it died during a
+/// test case report the test case as aborted and replace the worker. The fatal
+/// error reported by the worker itself, if any, is the only message of the
+/// crash, otherwise its exit status is.
+void IsolatedRunner::handleWorkerExit( Worker& aWorker, TestRunResult& aRunResult ) {
+  close( aWorker.toWorker );
+  close( aWorker.fromWorker );
+  int status = 0;
+  while( waitpid( aWorker.pid, &status, 0 ) < 0 && errno == EINTR ) {
+  }
+  aWorker.pid = -1;
+
+  if( aWorker.testIndex < 0 )
+    return;
+
+  const TestCaseInfo& testInfo = ( *mTests )[ aWorker.testIndex ]->testInfo();
+  if( !aWorker.testStarted )
+    aWorker.report.reportTestCaseStart( testInfo );
+
+  TestCaseResult crash;
+  if( aWorker.fatalResult && !aWorker.killed ) {
+    crash.takeState( *aWorker.fatalResult );
+  } else {
+    crash.logAbort();
+    crash.logMessage( TestCaseResult::Error, describeExit( "worker", status, aWorker.killed ) );
+  }
+  aWorker.fatalResult.reset();
+  aRunResult.add( crash );
+  // the logs are reported with the innermost section, the counters with all of them
+  for( auto it = aWorker.openSections.rbegin(); it != aWorker.openSections.rend(); ++it )
+    aWorker.report.reportTestSectionEnd( *it, crash, Timing() );
+  aWorker.report.reportTestCaseEnd( testInfo, crash, Timing() );
+  aWorker.report.flushTo( *mTestReport );
+  recordDuration( aWorker );
+
+  if( mNextTest < mTests->size() && spawnWorker( aWorker ) )
+    assignNextTest( aWorker );
+}
+
+/// The workers enforce the timeouts themselves, a worker not terminated by
+/// its own watchdog is killed after a grace period.
+/// Return the poll timeout in milliseconds until the next deadline, -1 if none.
+int IsolatedRunner::killOverdueWorkers() {
+  const auto now = std::chrono::steady_clock::now();
+  double next = -1;
+  for( auto& w : mWorkers ) {
+    if( !w->isAlive() || w->testIndex < 0 || w->killed )
+      continue;
+    double timeout = mFramework.getTimeout( ( *mTests )[ w->testIndex ]->testInfo() );
+    if( timeout <= 0 )
+      continue;
+    double left = timeout + kTimeoutGraceSeconds - std::chrono::duration<double>( now - w->testStart ).count();
+    if( left <= 0 ) {
+      // the pipe is closed by the kill, the exit is handled then
+      kill( w->pid, SIGKILL );
+      w->killed = true;
+    } else if( next < 0 || left < next ) {
+      next = left;
+    }
+  }
+  return next < 0 ? -1 : static_cast<int>( next * 1000 ) + 1;
+}
+
+
+void IsolatedRunner::recordDuration( Worker& aWorker ) {
+  const TestCaseInfo& testInfo = ( *mTests )[ aWorker.testIndex ]->testInfo();
+  mFramework.recordDuration(
+    testInfo, std::chrono::duration<double>( std::chrono::steady_clock::now() - aWorker.testStart ).count() );
+}
+
+
+Zygote::Zygote( Framework& aFramework, ITestReport* aTestReport )
+    : mFramework( aFramework )
+    , mTestReport( aTestReport ? aTestReport : aFramework.getTestReport() ) {
+}
+
+
+/// Fork the run and report the events of the child as they arrive. The child
+/// reports complete test cases one after the other, also under --jobs where
+/// they are flushed under the report lock. If the child dies the test case
+/// running is reported as aborted, as for a worker of the IsolatedRunner.
+void Zygote::run( const std::vector<ITestCase*>& aTests, TestRunResult& aRunResult ) {
+  int fds[ 2 ];
+  if( pipe( fds ) != 0 ) {
+    mFramework.runTests( aTests, aRunResult );
+    return;
+  }
+
+  // don't let the child print the pending output of the parent again
+  std::cout.flush();
+  fflush( nullptr );
+
+  pid_t pid = ::fork();
+  if( pid < 0 ) {
+    close( fds[ 0 ] );
+    close( fds[ 1 ] );
+    mFramework.runTests( aTests, aRunResult );
+    return;
+  }
+
+  if( pid == 0 ) {
+    close( fds[ 0 ] );
+    PipeTestReport report( fds[ 1 ] );
+    mFramework.mTestReport = &report;
+    mFramework.mMainContext.mTestReport = &report;
+    mFramework.mMainContext.mForked = true;
+    const std::map<const AssertionSite*, SiteCounts> sites = getSiteCounts();
+    TestRunResult runResult;
+    mFramework.runTests( aTests, runResult );
+
+    report.send( siteMessage( sites ) );
+    MessageWriter message( EMessage::RunResult );
+    message.add( runResult.getPassedTestCount() );
+    message.add( runResult.getFailedTestCount() );
+    message.add( runResult.getPassedAssertionCount() );
+    message.add( runResult.getFailedAssertionCount() );
+    const DurationHistory& history = mFramework.mTestRegistry.getDurationHistory();
+    for( ITestCase* tc : aTests ) {
+      double seconds;
+      if( history.getDuration( tc->testInfo().name, seconds ) )
+        message.add( tc->testInfo().name ).add( seconds );
+    }
+    report.send( message );
+
+    std::cout.flush();
+    fflush( nullptr );
+    _exit( 0 );
+  }
+
+  close( fds[ 1 ] );
+  std::map<std::string, const TestCaseInfo*> infos;
+  for( ITestCase* tc : aTests )
+    infos[ tc->testInfo().name ] = &tc->testInfo();
+
+  const TestCaseInfo* testInfo = nullptr; ///< the test case started and not yet ended
+  std::vector<SectionInfo> openSections;
+  std::unique_ptr<TestCaseResult> fatalResult;
+  TestRunResult reported; ///< the results of the reported test cases, kept if the run result is lost
+  bool hasRunResult = false;
+
+  std::string input;
+  std::vector<char> buffer( 64 * 1024 );
+  for( ;; ) {
+    ssize_t n = ::read( fds[ 0 ], buffer.data(), buffer.size() );
+    if( n < 0 && errno == EINTR )
+      continue;
+    if( n <= 0 )
+      break;
+    input.append( buffer.data(), static_cast<size_t>( n ) );
+
+    size_t pos = 0;
+    EMessage type;
+    MessageReader reader( nullptr, 0 );
+    while( nextMessage( input, pos, type, reader ) ) {
+      switch( type ) {
+      case EMessage::TestCaseStart: {
+        auto it = infos.find( reader.getString() );
+        testInfo = it != infos.end() ? it->second : &Framework::unboundChecksInfo();
+        openSections.clear();
+        mTestReport->reportTestCaseStart( *testInfo );
+      } break;
+
+      case EMessage::TestSectionStart:
+        openSections.emplace_back( reader.getString() );
+        mTestReport->reportTestSectionStart( openSections.back() );
+        break;
+
+      case EMessage::TestSectionSkip:
+        mTestReport->reportTestSectionSkip( SectionInfo( reader.getString() ) );
+        break;
+
+      case EMessage::TestSectionEnd: {
+        SectionInfo info( reader.getString() );
+        Timing timing = reader.getTiming();
+        TestCaseResult result;
+        reader.getResult( result );
+        if( !openSections.empty() )
+          openSections.pop_back();
+        mTestReport->reportTestSectionEnd( info, result, timing );
+      } break;
+
+      case EMessage::TestCaseEnd: {
+        ACATCH_INTERNAL_ASSERT( testInfo );
+        Timing timing = reader.getTiming();
+        TestCaseResult result;
+        reader.getResult( result );
+        reported.add( result );
+        mTestReport->reportTestCaseEnd( *testInfo, result, timing );
+        testInfo = nullptr;
+      } break;
+
+      case EMessage::LogNow: {
+        TestCaseResult result;
+        reader.getResult( result );
+        mTestReport->reportLogNow( result );
+      } break;
+
+      case EMessage::Fatal:
+        fatalResult.reset( new TestCaseResult() );
+        reader.getResult( *fatalResult );
+        break;
+
+      case EMessage::Sites:
+        while( !reader.atEnd() ) {
+          AssertionSite* site = reinterpret_cast<AssertionSite*>( static_cast<uintptr_t>( reader.getUint64() ) );
+          uint64_t hits = reader.getUint64();
+          uint64_t fails = reader.getUint64();
+          bool failed = reader.getUint() != 0;
+          std::string firstFailure = reader.getString();
+          site->addCounts( hits, fails, failed ? &firstFailure : nullptr );
+        }
+        break;
+
+      case EMessage::RunResult: {
+        uint64_t passedTests = reader.getUint64();
+        uint64_t failedTests = reader.getUint64();
+        uint64_t passedAssertions = reader.getUint64();
+        uint64_t failedAssertions = reader.getUint64();
+        aRunResult.addCounts( passedTests, failedTests, passedAssertions, failedAssertions );
+        while( !reader.atEnd() ) {
+          std::string name = reader.getString();
+          mFramework.mTestRegistry.getDurationHistory().setDuration( name, reader.getDouble() );
+        }
+        hasRunResult = true;
+      } break;
+
+      case EMessage::Done:
+        break;
+      }
+    }
+    input.erase( 0, pos );
+  }
+  close( fds[ 0 ] );
+
+  int status = 0;
+  while( waitpid( pid, &status, 0 ) < 0 && errno == EINTR ) {
+  }
+  if( hasRunResult )
+    return;
+
+  // the run result is lost: the reported test cases are counted, the running
+  // one is ended with the fatal error of the child or else its exit status
+  TestCaseResult crash;
+  if( fatalResult ) {
+    crash.takeState( *fatalResult );
+  } else {
+    crash.logAbort();
+    crash.logMessage( TestCaseResult::Error, describeExit( "test run", status, false ) );
+  }
+  if( testInfo ) {
+    for( auto it = openSections.rbegin(); it != openSections.rend(); ++it )
+      mTestReport->reportTestSectionEnd( *it, crash, Timing() );
+    mTestReport->reportTestCaseEnd( *testInfo, crash, Timing() );
+  } else {
+    std::cerr << describeExit( "test run", status, false ) << "\n";
+  }
+  reported.add( crash );
+  aRunResult.add( reported );
+}
+
+
+SectionForker::SectionForker( double aTimeoutSeconds )
+    : mHasDeadline( aTimeoutSeconds > 0 )
+    , mOutput( -1 )
+    , mChild( 0 ) {
+  if( mHasDeadline )
+    mDeadline = std::chrono::steady_clock::now()
+                + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>( aTimeoutSeconds ) );
+}
+
+
+SectionForker::~SectionForker() {
+}
+
+
+bool SectionForker::isSupported() {
+  return true;
+}
+
+
+bool SectionForker::fork( RunContext& aContext ) {
+  int fds[ 2 ];
+  if( pipe( fds ) != 0 )
+    return true;
+
+  // don't let the child print the pending output of the parent again
+  std::cout.flush();
+  fflush( nullptr );
+
+  pid_t pid = ::fork();
+  if( pid < 0 ) {
+    close( fds[ 0 ] );
+    close( fds[ 1 ] );
+    return true;
+  }
+
+  if( pid == 0 ) {
+    close( fds[ 0 ] );
+    mOutput = fds[ 1 ];
+    mReport.reset( new PipeTestReport( mOutput ) );
+    aContext.mTestReport = mReport.get();
+    aContext.mForked = true;
+    // the results so far belong to the parent
+    TestCaseResult::Logs logs;
+    aContext.mCurrentResult->takeLogs( logs );
+    aContext.mCurrentResult->restoreCounts( 0, false, 0, false );
+    if( mHasDeadline ) {
+      // the watchdog thread is not forked, the parent kills the child on timeout
+      // and the alarm is a backstop for the processes forked by the child
+      double left = std::chrono::duration<double>( mDeadline - std::chrono::steady_clock::now() ).count();
+      alarm( static_cast<unsigned>( std::max( 0.0, left ) ) + 2 );
+    }
+    mChild = 0;
+    return true;
+  }
+
+  close( fds[ 1 ] );
+  mChild = pid;
+
+  // counters and logs of the child outside of its own sections
+  TestCaseResult result;
+  std::vector<SectionInfo> openSections;
+  bool ended = false;
+  bool fatal = false; ///< the child reported its fatal error
+  std::string input;
+  std::vector<char> buffer( 64 * 1024 );
+  for( ;; ) {
+    ssize_t n = ::read( fds[ 0 ], buffer.data(), buffer.size() );
+    if( n < 0 && errno == EINTR )
+      continue;
+    if( n <= 0 )
+      break;
+    input.append( buffer.data(), static_cast<size_t>( n ) );
+
+    size_t pos = 0;
+    EMessage type;
+    MessageReader reader( nullptr, 0 );
+    while( nextMessage( input, pos, type, reader ) ) {
+      switch( type ) {
+      case EMessage::TestSectionStart: {
+        openSections.emplace_back( reader.getString() );
+        std::lock_guard<std::mutex> lg( aContext.mWatchMutex );
+        aContext.mForkedSections.push_back( openSections.back().name );
+        aContext.mTestReport->reportTestSectionStart( openSections.back() );
+      } break;
+
+      case EMessage::TestSectionSkip:
+        aContext.mTestReport->reportTestSectionSkip( SectionInfo( reader.getString() ) );
+        break;
+
+      case EMessage::TestSectionEnd: {
+        SectionInfo info( reader.getString() );
+        Timing timing = reader.getTiming();
+        TestCaseResult sectionResult;
+        reader.getResult( sectionResult );
+        if( !openSections.empty() ) {
+          openSections.pop_back();
+          std::lock_guard<std::mutex> lg( aContext.mWatchMutex );
+          aContext.mForkedSections.pop_back();
+          aContext.mTestReport->reportTestSectionEnd( info, sectionResult, timing );
+        } else {
+          // a section entered before the fork, it is ended by the parent
+          result.takeState( sectionResult );
+        }
+      } break;
+
+      case EMessage::TestCaseEnd: {
+        reader.getTiming();
+        TestCaseResult caseResult;
+        reader.getResult( caseResult );
+        result.takeState( caseResult );
+        ended = true;
+      } break;
+
+      case EMessage::LogNow: {
+        TestCaseResult logResult;
+        reader.getResult( logResult );
+        aContext.mTestReport->reportLogNow( logResult );
+      } break;
+
+      case EMessage::Fatal: {
+        TestCaseResult fatalResult;
+        reader.getResult( fatalResult );
+        result.takeState( fatalResult );
+        fatal = true;
+      } break;
+
+      case EMessage::TestCaseStart:
+      case EMessage::Done:
+      case EMessage::RunResult:
+      case EMessage::Sites:
+        break;
+      }
+    }
+    input.erase( 0, pos );
+  }
+  close( fds[ 0 ] );
+  {
+    // a child killed on timeout is reported by the watchdog, which holds the lock
+    std::lock_guard<std::mutex> lg( aContext.mWatchMutex );
+    aContext.mForkedSections.clear();
+  }
+
+  int status = 0;
+  while( waitpid( pid, &status, 0 ) < 0 && errno == EINTR ) {
+  }
+  mChild = 0;
+
+  if( !ended ) {
+    if( !fatal ) {
+      result.logAbort();
+      result.logMessage( TestCaseResult::Error, describeExit( "section", status, false ) );
+    }
+    for( auto it = openSections.rbegin(); it != openSections.rend(); ++it )
+      aContext.mTestReport->reportTestSectionEnd( *it, result, Timing() );
+  }
+  aContext.mCurrentResult->merge( result );
+  return false;
+}
+
+
+void SectionForker::exitForked() {
+  std::cout.flush();
+  fflush( nullptr );
+  _exit( 0 );
+}
+
+
+void SectionForker::killChild() {
+  int pid = mChild;
+  if( pid > 0 )
+    kill( pid, SIGKILL );
+}
+
+#else // ACATCH_INTERNAL_HAS_FORK
+
+struct IsolatedRunner::Worker {};
+
+
+IsolatedRunner::IsolatedRunner( Framework& aFramework, uint aWorkerCount, ITestReport* aTestReport )
+    : mFramework( aFramework )
+    , mTestReport( aTestReport ? aTestReport : aFramework.getTestReport() )
+    , mWorkerCount( aWorkerCount )
+    , mTests( nullptr )
+    , mNextTest( 0 ) {
+}
+
+
+IsolatedRunner::~IsolatedRunner() {
+}
+
+
+void IsolatedRunner::run( const std::vector<ITestCase*>& aTests, TestRunResult& aRunResult ) {
+  // no process isolation on this platform
+  for( ITestCase* tc : aTests )
+    mFramework.runTest( mFramework.mMainContext, *tc, aRunResult );
+}
+
+
+Zygote::Zygote( Framework& aFramework, ITestReport* aTestReport )
+    : mFramework( aFramework )
+    , mTestReport( aTestReport ? aTestReport : aFramework.getTestReport() ) {
+}
+
+
+void Zygote::run( const std::vector<ITestCase*>& aTests, TestRunResult& aRunResult ) {
+  // no fork on this platform, the runs share the process
+  mFramework.runTests( aTests, aRunResult );
+}
+
+
+SectionForker::SectionForker( double /*aTimeoutSeconds*/ )
+    : mHasDeadline( false )
+    , mOutput( -1 )
+    , mChild( 0 ) {
+}
+
+
+SectionForker::~SectionForker() {
+}
+
+
+bool SectionForker::isSupported() {
+  return false;
+}
+
+
+bool SectionForker::fork( RunContext& /*aContext*/ ) {
+  // the sections are replayed in-process
+  return true;
+}
+
+
+void SectionForker::exitForked() {
+}
+
+
+void SectionForker::killChild() {
+}
+
+#endif // ACATCH_INTERNAL_HAS_FORK
+
+} // namespace ACatch
@@ -0,0 +1,104 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+namespace ACatch {
+
+namespace {
+
+const size_t kAlignment = alignof( std::max_align_t );
+const size_t kFirstBlockSize = 1024;      ///< small for the results logging a few messages
+const size_t kMaxBlockSize = 64 * 1024;   ///< the block size doubles up to this size
+
+size_t alignUp( size_t aSize ) {
+  return ( aSize + kAlignment - 1 ) & ~( kAlignment - 1 );
+}
+
+} // namespace
+
+
+LogArena::LogArena()
+    : mCurrent( nullptr )
+    , mFirst( nullptr )
+    , mBlockCount( 0 ) {
+}
+
+
+LogArena::~LogArena() {
+  while( mFirst ) {
+    Block* next = mFirst->next;
+    mFirst->~Block();
+    ::operator delete( mFirst );
+    mFirst = next;
+  }
+}
+
+
+void* LogArena::allocate( size_t aSize ) {
+  aSize = alignUp( aSize );
+  for( ;; ) {
+    Block* block = mCurrent.load( std::memory_order_acquire );
+    if( block ) {
+      size_t pos = block->used.fetch_add( aSize, std::memory_order_relaxed );
+      if( pos + aSize <= block->capacity )
+        return block->data() + pos;
+    }
+    std::lock_guard<std::mutex> lg( mMutex );
+    if( mCurrent.load( std::memory_order_relaxed ) == block )
+      mCurrent.store( nextBlock( block, aSize ), std::memory_order_release );
+  }
+}
+
+
+StringRef LogArena::copy( const StringRef& aString ) {
+  char* data = static_cast<char*>( allocate( aString.size() ) );
+  std::memcpy( data, aString.data(), aString.size() );
+  return StringRef( data, aString.size() );
+}
+
+
+void LogArena::reset() {
+  std::lock_guard<std::mutex> lg( mMutex );
+  if( mFirst )
+    mFirst->used.store( 0, std::memory_order_relaxed );
+  mCurrent.store( mFirst, std::memory_order_release );
+}
+
+
+size_t LogArena::getBlockCount() const {
+  std::lock_guard<std::mutex> lg( mMutex );
+  return mBlockCount;
+}
+
+
+/// The block following an exhausted one: the next block of the chain if it is
+/// large enough (left by a reset), otherwise a new block inserted in the chain.
+/// Called with mMutex held.
+LogArena::Block* LogArena::nextBlock( Block* aExhausted, size_t aSize ) {
+  Block* next = aExhausted ? aExhausted->next : mFirst;
+  if( next && next->capacity >= aSize ) {
+    next->used.store( 0, std::memory_order_relaxed );
+    return next;
+  }
+
+  size_t capacity = aExhausted ? std::min( aExhausted->capacity * 2, kMaxBlockSize ) : kFirstBlockSize;
+  capacity = std::max( capacity, aSize );
+  Block* block = new( ::operator new( sizeof( Block ) + capacity ) ) Block();
+  block->used.store( 0, std::memory_order_relaxed );
+  block->capacity = capacity;
+  block->next = next;
+  if( aExhausted )
+    aExhausted->next = block;
+  else
+    mFirst = block;
+  ++mBlockCount;
+  return block;
+}
+
+} // namespace ACatch
@@ -0,0 +1,66 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+namespace ACatch {
+
+namespace Detail {
+
+namespace {
+
+const size_t kWindow = 2; ///< elements shown on each side of a mismatch
+
+/// The elements around aIndex, the mismatching one between > <
+void appendWindow( std::string& aOut, const void* aData, size_t aSize, size_t aIndex,
+                   std::string ( *aFormat )( const void*, size_t ) ) {
+  size_t begin = aIndex > kWindow ? aIndex - kWindow : 0;
+  size_t end = aIndex + kWindow + 1 < aSize ? aIndex + kWindow + 1 : aSize;
+  aOut += "{ ";
+  if( begin > 0 )
+    aOut += "..., ";
+  for( size_t i = begin; i < end; ++i ) {
+    if( i > begin )
+      aOut += ", ";
+    if( i == aIndex )
+      aOut += ">" + aFormat( aData, i ) + "<";
+    else
+      aOut += aFormat( aData, i );
+  }
+  if( end < aSize )
+    aOut += ", ...";
+  aOut += " }";
+}
+
+} // namespace
+
+
+std::string rangeMismatchesToString( const void* aLhs, size_t aLhsSize, const void* aRhs, size_t aRhsSize,
+                                     const size_t* aMismatches, size_t aShown, uint64_t aCount,
+                                     const std::string& aTolerance,
+                                     std::string ( *aFormat )( const void*, size_t ) ) {
+  size_t size = aLhsSize < aRhsSize ? aLhsSize : aRhsSize;
+  std::string out = std::to_string( aCount ) + " mismatches in " + std::to_string( size ) + " elements";
+  if( !aTolerance.empty() )
+    out += " with tolerance " + aTolerance;
+  if( aLhsSize != aRhsSize )
+    out += ", sizes differ: " + std::to_string( aLhsSize ) + " != " + std::to_string( aRhsSize );
+  for( size_t i = 0; i < aShown; ++i ) {
+    out += "\n  [" + std::to_string( aMismatches[ i ] ) + "] ";
+    appendWindow( out, aLhs, aLhsSize, aMismatches[ i ], aFormat );
+    out += " != ";
+    appendWindow( out, aRhs, aRhsSize, aMismatches[ i ], aFormat );
+  }
+  if( aCount > aShown )
+    out += "\n  ... " + std::to_string( aCount - aShown ) + " more mismatches";
+  return out;
+}
+
+} // namespace Detail
+
+} // namespace ACatch
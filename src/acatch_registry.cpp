@@ -10,6 +10,20 @@
 
 namespace ACatch {
 
+namespace {
+
+/// FNV-1a hash of the name, it is stable across builds and platforms
+uint64_t stableHash( const std::string& aName ) {
+  uint64_t hash = 14695981039346656037ull;
+  for( unsigned char c : aName ) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+} // namespace
+
 struct ITestCase_LexSort {
   bool operator()( const ITestCase* a1, const ITestCase* a2 ) const {
     const std::string n1 = a1->testInfo().name;
@@ -23,6 +37,21 @@ struct ITestCase_LexSort {
   }
 };
 
+struct ITestCase_DurationSort {
+  const DurationHistory& history;
+
+  bool operator()( const ITestCase* a1, const ITestCase* a2 ) const {
+    double d1, d2;
+    bool has1 = history.getDuration( a1->testInfo().name, d1 );
+    bool has2 = history.getDuration( a2->testInfo().name, d2 );
+    if( has1 != has2 )
+      return has1;
+    if( has1 && d1 != d2 )
+      return d1 > d2;
+    return ITestCase_LexSort()( a1, a2 );
+  }
+};
+
 std::vector<ITestCase*> TestRegistry::getAllTests( RunOrder aOrder ) const {
   std::vector<ITestCase*> tests;
   tests.reserve( mFunctions.size() );
@@ -42,17 +71,37 @@ std::vector<ITestCase*> TestRegistry::getAllTests( RunOrder aOrder ) const {
   case RunOrder::InDeclarationOrder:
     // already in declaration order
     break;
+
+  case RunOrder::InDurationHistoryOrder:
+    std::sort( tests.begin(), tests.end(), ITestCase_DurationSort{ mDurationHistory } );
+    break;
   }
 
   return tests;
 }
 
+/// The test cases of a shard in run order. The shard of a test case depends only
+/// on its name, so the machines running the shards agree on the split whatever
+/// their own duration history.
+std::vector<ITestCase*> TestRegistry::getShardTests( RunOrder aOrder, uint aShardIndex, uint aShardCount ) const {
+  std::vector<ITestCase*> tests = getAllTests( aOrder );
+  if( aShardCount <= 1 )
+    return tests;
+
+  tests.erase( std::remove_if( tests.begin(), tests.end(),
+                               [&]( const ITestCase* aTest ) {
+                                 return stableHash( aTest->testInfo().name ) % aShardCount != aShardIndex;
+                               } ),
+               tests.end() );
+  return tests;
+}
+
 void AutoReg::registerTestCase( ITestCase* aTestCase ) {
   theACatch().registerTestCase( aTestCase );
 }
 
-void AutoReg::registerPreInit( FnPreInit aPreInit ) {
-	theACatch().registerPreInit( aPreInit );
+void AutoReg::registerPreInit( FnPreInit aPreInit, const PreInitInfo& aInfo ) {
+	theACatch().registerPreInit( aPreInit, aInfo );
 }
 
 } // namespace ACatch
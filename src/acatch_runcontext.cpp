@@ -0,0 +1,25 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+namespace ACatch {
+
+namespace {
+thread_local RunContext* sCurrentContext = nullptr;
+} // namespace
+
+RunContext* RunContext::current() {
+  return sCurrentContext;
+}
+
+void RunContext::setCurrent( RunContext* aContext ) {
+  sCurrentContext = aContext;
+}
+
+} // namespace ACatch
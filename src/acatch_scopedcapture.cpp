@@ -0,0 +1,27 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+namespace ACatch {
+
+std::vector<std::string> ScopedCapture::formatActive() {
+  const Stack& stack = getStack();
+  std::vector<std::string> captures;
+  size_t count = stack.depth < kCapacity ? stack.depth : kCapacity;
+  captures.reserve( count + 1 );
+  for( size_t i = 0; i < count; ++i ) {
+    const Entry& entry = stack.entries[ i ];
+    captures.push_back( std::string( "\"" ) + entry.expression + "\" = " + entry.format( entry.value ) );
+  }
+  if( stack.depth > kCapacity )
+    captures.push_back( "... " + std::to_string( stack.depth - kCapacity ) + " more captures" );
+  return captures;
+}
+
+} // namespace ACatch
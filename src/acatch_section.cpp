@@ -13,15 +13,16 @@ namespace ACatch {
 Section::Section( const SectionInfo& aInfo )
     : mInfo( aInfo )
     , mSectionIncluded( theACatch().sectionStarted( mInfo ) ) {
-  // m_timer.start();
+  if( mSectionIncluded )
+    mTimer.start();
 }
 
 Section::~Section() {
   if( mSectionIncluded ) {
     if( std::uncaught_exception() )
-      theACatch().sectionEndedEarly( mInfo );
+      theACatch().sectionEndedEarly( mInfo, mTimer.getElapsed() );
     else
-      theACatch().sectionEnded( mInfo );
+      theACatch().sectionEnded( mInfo, mTimer.getElapsed() );
   }
 }
 
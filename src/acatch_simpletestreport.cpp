@@ -8,17 +8,26 @@
 
 #include "acatch/acatch_core.hpp"
 
+#include <iomanip>
+#include <sstream>
+
 namespace ACatch {
 
 SimpleTestReport::SimpleTestReport()
     : mVerbose( true )
-    , mDepth( 0 ) {
+    , mDepth( 0 )
+    , mSlowestCount( 10 )
+    , mAllSites( false ) {
 }
 
 
 void SimpleTestReport::setProperty( const std::string& aProp, const std::string& aValue ) {
   if( aProp == "verbose" ) {
     mVerbose = ( aValue == "true" );
+  } else if( aProp == "slowest" ) {
+    mSlowestCount = static_cast<size_t>( std::stoul( aValue ) );
+  } else if( aProp == "sites" ) {
+    mAllSites = ( aValue == "all" );
   }
 }
 
@@ -30,6 +39,13 @@ void SimpleTestReport::reportTestCases( const ConstTestCaseInfoRefs& aInfos ) {
 }
 
 
+void SimpleTestReport::reportShard( uint aShardIndex, uint aShardCount, const ConstTestCaseInfoRefs& aInfos ) {
+  std::cout << "shard " << aShardIndex << " of " << aShardCount << ": (" << aInfos.size() << ")\n";
+  for( const TestCaseInfo* tc : aInfos )
+    std::cout << "  " << tc->name << " \n";
+}
+
+
 void SimpleTestReport::reportTestCaseSkip( const TestCaseInfo& aInfo ) {
   mNames.clear();
   mNames.push_back( aInfo.name );
@@ -47,12 +63,14 @@ void SimpleTestReport::reportTestCaseStart( const TestCaseInfo& aInfo ) {
 
 
 void SimpleTestReport::reportTestSectionSkip( const SectionInfo& aInfo ) {
+  mNames.resize( mDepth ); // drop the sections ended in this cycle
   mNames.push_back( aInfo.name );
   printTestName( State::Skip );
 }
 
 
 void SimpleTestReport::reportTestSectionStart( const SectionInfo& aInfo ) {
+  mNames.resize( mDepth );
   mNames.push_back( aInfo.name );
   ++mDepth;
   ACATCH_INTERNAL_ASSERT( mDepth == mNames.size() );
@@ -60,13 +78,20 @@ void SimpleTestReport::reportTestSectionStart( const SectionInfo& aInfo ) {
 }
 
 
-void SimpleTestReport::reportTestSectionEnd( const SectionInfo& /*aInfo*/, TestCaseResult& aResult ) {
+void SimpleTestReport::reportTestSectionEnd( const SectionInfo& /*aInfo*/, TestCaseResult& aResult, const Timing& aTiming ) {
+  std::string name = mNames[ 0 ];
+  for( size_t i = 1; i < mDepth && i < mNames.size(); ++i )
+    name += "." + mNames[ i ];
+  mSectionTimings[ name ] += aTiming;
+
   printTestResult( aResult, true );
   --mDepth;
 }
 
 
-void SimpleTestReport::reportTestCaseEnd( const TestCaseInfo& /*aInfo*/, TestCaseResult& aResult ) {
+void SimpleTestReport::reportTestCaseEnd( const TestCaseInfo& aInfo, TestCaseResult& aResult, const Timing& aTiming ) {
+  mTestTimings[ aInfo.name ] += aTiming;
+
   printTestResult( aResult, true );
   --mDepth;
   ACATCH_INTERNAL_ASSERT( mDepth == 0 );
@@ -85,6 +110,48 @@ void SimpleTestReport::reportTestRun( const ConstTestCaseInfoRefs& aInfos, TestR
   std::cout << "  Passed tests:      " << aRunResult.getPassedTestCount() << "\n";
   std::cout << "  Failed assertions: " << aRunResult.getFailedAssertionCount() << "\n";
   std::cout << "  Passed assertions: " << aRunResult.getPassedAssertionCount() << "\n";
+
+  if( mSlowestCount > 0 ) {
+    printSlowest( "test cases", mTestTimings );
+    printSlowest( "sections", mSectionTimings );
+  }
+}
+
+
+/// Reports the failed assertion sites, or all the sites with the "sites" property
+/// set to "all". A site failing repeatedly is reported once with its counters and
+/// the values of its first failure. The hits are shown when they are counted.
+void SimpleTestReport::reportAssertionSites( const std::vector<const AssertionSite*>& aSites ) {
+  std::vector<const AssertionSite*> reached;
+  std::vector<const AssertionSite*> unreached;
+  for( const AssertionSite* site : aSites ) {
+    if( !site->isReached() )
+      unreached.push_back( site );
+    else if( mAllSites || site->getFails() > 0 )
+      reached.push_back( site );
+  }
+
+  const bool hits = AssertionSite::isCountingHits();
+  if( !reached.empty() ) {
+    std::cout << "\n" << ( mAllSites ? "Assertion sites" : "Failed assertion sites" ) << ":\n";
+    std::cout << ( hits ? "        hits        fails\n" : "       fails\n" );
+    const std::string indent( hits ? 27 : 14, ' ' );
+    for( const AssertionSite* site : reached ) {
+      std::cout << "  ";
+      if( hits )
+        std::cout << std::setw( 10 ) << site->getHits() << " ";
+      std::cout << std::setw( hits ? 12 : 10 ) << site->getFails()
+                << "  " << site->location() << ": " << site->kind << "( " << site->expression << " )\n";
+      if( site->getFails() > 0 )
+        std::cout << indent << "first failure: " << site->getFirstFailure() << "\n";
+    }
+  }
+
+  if( mAllSites && !unreached.empty() ) {
+    std::cout << "\nAssertion sites never reached:\n";
+    for( const AssertionSite* site : unreached )
+      std::cout << "  " << site->location() << ": " << site->kind << "( " << site->expression << " )\n";
+  }
 }
 
 
@@ -110,6 +177,35 @@ void SimpleTestReport::printTestResult( TestCaseResult& aResult, bool aCompleted
 }
 
 
+/// Reports the slowest items by wall-clock time
+void SimpleTestReport::printSlowest( const char* aTitle, const Timings& aTimings ) {
+  if( aTimings.empty() )
+    return;
+
+  std::vector<Timings::const_iterator> items;
+  items.reserve( aTimings.size() );
+  for( auto it = aTimings.begin(); it != aTimings.end(); ++it )
+    items.push_back( it );
+
+  size_t count = std::min( mSlowestCount, items.size() );
+  std::partial_sort( items.begin(), items.begin() + count, items.end(),
+                     []( Timings::const_iterator a, Timings::const_iterator b ) {
+                       return a->second.wallSeconds > b->second.wallSeconds;
+                     } );
+
+  std::cout << "\nSlowest " << aTitle << ":\n";
+  std::cout << "     wall [ms]     cpu [ms]\n";
+  std::ostringstream lines; // the format of std::cout is left untouched
+  lines << std::fixed << std::setprecision( 3 );
+  for( size_t i = 0; i < count; ++i ) {
+    lines << "  " << std::setw( 12 ) << items[ i ]->second.wallSeconds * 1000.
+          << " " << std::setw( 12 ) << items[ i ]->second.cpuSeconds * 1000.
+          << "  " << items[ i ]->first << "\n";
+  }
+  std::cout << lines.str();
+}
+
+
 /// Reports the name of the current test
 void SimpleTestReport::printTestName( State aState ) {
   if( !mVerbose && ( aState == State::Runing || aState == State::Skip ) ) {
@@ -132,6 +228,8 @@ void SimpleTestReport::printTestName( State aState ) {
     case State::Skip:
       std::cout << ". ";
       break;
+    case State::List:
+      break;
   }
 
   for( size_t i = 0; i < mNames.size(); ++i ) {
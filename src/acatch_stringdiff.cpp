@@ -0,0 +1,289 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+namespace ACatch {
+
+namespace Detail {
+
+namespace {
+
+const size_t kContextLines = 3;     ///< unchanged lines shown around a change
+const size_t kContextChars = 20;    ///< unchanged bytes shown around a change of a line
+const size_t kShownGroups = 10;     ///< changes with their context shown
+const size_t kShownLines = 8;       ///< lines shown on each side of a change
+const size_t kShownLineChanges = 8; ///< changes shown in a line
+const size_t kLineEdits = 1000;
+const size_t kLineSteps = 20000000;
+const size_t kCharEdits = 200;
+const size_t kCharSteps = 20000000;
+
+/// The lines of a string, without their line break
+class Lines
+{
+public:
+  explicit Lines( const StringRef& aString )
+      : mData( aString.data() ) {
+    const char* end = aString.data() + aString.size();
+    const char* line = aString.data();
+    for( ;; ) {
+      const char* lineEnd = static_cast<const char*>( std::memchr( line, '\n', static_cast<size_t>( end - line ) ) );
+      if( !lineEnd )
+        lineEnd = end;
+      mBegins.push_back( static_cast<size_t>( line - mData ) );
+      mHashes.push_back( hash( line, lineEnd ) );
+      if( lineEnd == end )
+        break;
+      line = lineEnd + 1;
+    }
+    mBegins.push_back( aString.size() + 1 );
+  }
+
+  size_t size() const {
+    return mHashes.size();
+  }
+
+  StringRef line( size_t aIndex ) const {
+    return StringRef( mData + mBegins[ aIndex ], mBegins[ aIndex + 1 ] - mBegins[ aIndex ] - 1 );
+  }
+
+  bool equal( size_t aIndex, const Lines& aOther, size_t aOtherIndex ) const {
+    return mHashes[ aIndex ] == aOther.mHashes[ aOtherIndex ] && line( aIndex ) == aOther.line( aOtherIndex );
+  }
+
+private:
+  const char* mData;
+  std::vector<size_t> mBegins; ///< offset of each line and of the end of the string + 1
+  std::vector<uint64_t> mHashes;
+
+  /// FNV-1a
+  static uint64_t hash( const char* aBegin, const char* aEnd ) {
+    uint64_t h = 14695981039346656037ull;
+    for( ; aBegin != aEnd; ++aBegin )
+      h = ( h ^ static_cast<unsigned char>( *aBegin ) ) * 1099511628211ull;
+    return h;
+  }
+};
+
+template <typename T>
+struct DiffSides {
+  const T& lhs;
+  const T& rhs;
+};
+
+bool equalLines( const void* aContext, size_t aLhs, size_t aRhs ) {
+  const DiffSides<Lines>& lines = *static_cast<const DiffSides<Lines>*>( aContext );
+  return lines.lhs.equal( aLhs, lines.rhs, aRhs );
+}
+
+bool equalChars( const void* aContext, size_t aLhs, size_t aRhs ) {
+  const DiffSides<StringRef>& strings = *static_cast<const DiffSides<StringRef>*>( aContext );
+  return strings.lhs.data()[ aLhs ] == strings.rhs.data()[ aRhs ];
+}
+
+/// Quoted text with some parts elided as "..."
+class QuotedText
+{
+public:
+  QuotedText( std::string& aOut, const char* aData )
+      : mSink( aOut )
+      , mData( aData )
+      , mOpen( false )
+      , mEmpty( true ) {
+  }
+
+  ~QuotedText() {
+    if( mOpen || mEmpty )
+      mSink << ( mEmpty ? "\"\"" : "\"" );
+  }
+
+  void append( size_t aBegin, size_t aEnd ) {
+    open();
+    appendEscaped( mSink, mData, aBegin, aEnd );
+  }
+
+  void appendMark( char aMark ) {
+    open();
+    mSink << aMark;
+  }
+
+  void elide() {
+    if( mOpen )
+      mSink << '"';
+    mSink << "...";
+    mOpen = false;
+    mEmpty = false;
+  }
+
+  /// [aBegin, aEnd) with its middle elided, the head and the tail are kept as asked
+  void appendSpan( size_t aBegin, size_t aEnd, bool aHead, bool aTail ) {
+    size_t head = aHead ? kContextChars : 0;
+    size_t tail = aTail ? kContextChars : 0;
+    if( aEnd - aBegin <= head + tail ) {
+      append( aBegin, aEnd );
+      return;
+    }
+    if( head )
+      append( aBegin, aBegin + head );
+    elide();
+    if( tail )
+      append( aEnd - tail, aEnd );
+  }
+
+private:
+  StringSink mSink;
+  const char* mData;
+  bool mOpen;
+  bool mEmpty; ///< nothing appended yet, shown as ""
+
+  void open() {
+    if( !mOpen )
+      mSink << '"';
+    mOpen = true;
+    mEmpty = false;
+  }
+};
+
+void appendLine( std::string& aOut, const char* aMark, const StringRef& aLine ) {
+  aOut += "\n  ";
+  aOut += aMark;
+  aOut += " ";
+  QuotedText text( aOut, aLine.data() );
+  text.appendSpan( 0, aLine.size(), true, true );
+}
+
+/// A line with its changes between > <
+void appendChangedLine( std::string& aOut, const char* aMark, const StringRef& aLine, const std::vector<DiffHunk>& aHunks, bool aLhs ) {
+  aOut += "\n  ";
+  aOut += aMark;
+  aOut += " ";
+  QuotedText text( aOut, aLine.data() );
+  size_t shown = std::min( aHunks.size(), kShownLineChanges );
+  size_t position = 0;
+  for( size_t i = 0; i < shown; ++i ) {
+    size_t begin = aLhs ? aHunks[ i ].lhsBegin : aHunks[ i ].rhsBegin;
+    size_t end = begin + ( aLhs ? aHunks[ i ].lhsCount : aHunks[ i ].rhsCount );
+    text.appendSpan( position, begin, i > 0, true );
+    text.appendMark( '>' );
+    text.appendSpan( begin, end, true, true );
+    text.appendMark( '<' );
+    position = end;
+  }
+  if( shown < aHunks.size() ) {
+    text.appendSpan( position, position + std::min( kContextChars, aLine.size() - position ), true, false );
+    text.elide();
+    aOut += " (" + std::to_string( aHunks.size() - shown ) + " more changes)";
+  } else {
+    text.appendSpan( position, aLine.size(), true, false );
+  }
+}
+
+/// Two lines replacing each other, diffed by character
+void appendLinePair( std::string& aOut, const StringRef& aLhs, const StringRef& aRhs ) {
+  DiffSides<StringRef> sides{ aLhs, aRhs };
+  std::vector<DiffHunk> hunks;
+  diffSequences( aLhs.size(), aRhs.size(), &equalChars, &sides, kCharEdits, kCharSteps, hunks );
+  appendChangedLine( aOut, "-", aLhs, hunks, true );
+  appendChangedLine( aOut, "+", aRhs, hunks, false );
+}
+
+void appendLines( std::string& aOut, const char* aMark, const Lines& aLines, size_t aBegin, size_t aCount ) {
+  size_t shown = std::min( aCount, kShownLines );
+  for( size_t i = 0; i < shown; ++i )
+    appendLine( aOut, aMark, aLines.line( aBegin + i ) );
+  if( aCount > shown )
+    aOut += std::string( "\n  " ) + aMark + " ... " + std::to_string( aCount - shown ) + " more lines";
+}
+
+} // namespace
+
+
+std::string diffStrings( const StringRef& aLhs, const StringRef& aRhs ) {
+  if( aLhs.size() <= kStringDiffFullSize && aRhs.size() <= kStringDiffFullSize &&
+      !std::memchr( aLhs.data(), '\n', aLhs.size() ) && !std::memchr( aRhs.data(), '\n', aRhs.size() ) )
+    return std::string();
+
+  size_t common = std::min( aLhs.size(), aRhs.size() );
+  size_t first = 0;
+  while( first < common && aLhs.data()[ first ] == aRhs.data()[ first ] )
+    ++first;
+  size_t line = 1;
+  size_t lineBegin = 0;
+  for( const char* p = aLhs.data(); ( p = static_cast<const char*>( std::memchr( p, '\n', first - static_cast<size_t>( p - aLhs.data() ) ) ) ); ++p ) {
+    ++line;
+    lineBegin = static_cast<size_t>( p - aLhs.data() ) + 1;
+  }
+  std::string out = "\n  first difference at line " + std::to_string( line ) + ", column " + std::to_string( first - lineBegin + 1 );
+
+  Lines lhs( aLhs );
+  Lines rhs( aRhs );
+  DiffSides<Lines> sides{ lhs, rhs };
+  std::vector<DiffHunk> hunks;
+  if( !diffSequences( lhs.size(), rhs.size(), &equalLines, &sides, kLineEdits, kLineSteps, hunks ) )
+    out += ", too many changes to diff, the range differing is shown";
+
+  // the changes closer than twice the context are shown together
+  size_t shown = 0;
+  for( size_t group = 0; group < hunks.size(); ++shown ) {
+    size_t last = group;
+    while( last + 1 < hunks.size() &&
+           hunks[ last + 1 ].lhsBegin - ( hunks[ last ].lhsBegin + hunks[ last ].lhsCount ) <= 2 * kContextLines )
+      ++last;
+    if( shown == kShownGroups ) {
+      out += "\n  ... " + std::to_string( hunks.size() - group ) + " more changes";
+      break;
+    }
+    size_t before = std::min( kContextLines, hunks[ group ].lhsBegin );
+    size_t lhsEnd = hunks[ last ].lhsBegin + hunks[ last ].lhsCount;
+    size_t after = std::min( kContextLines, lhs.size() - lhsEnd );
+    size_t lhsBegin = hunks[ group ].lhsBegin - before;
+    size_t rhsBegin = hunks[ group ].rhsBegin - before;
+    out += "\n  @@ -" + std::to_string( lhsBegin + 1 ) + "," + std::to_string( lhsEnd + after - lhsBegin ) + " +" +
+           std::to_string( rhsBegin + 1 ) + "," + std::to_string( hunks[ last ].rhsBegin + hunks[ last ].rhsCount + after - rhsBegin ) + " @@";
+    size_t position = lhsBegin;
+    for( size_t i = group; i <= last; ++i ) {
+      const DiffHunk& hunk = hunks[ i ];
+      appendLines( out, " ", lhs, position, hunk.lhsBegin - position );
+      if( hunk.lhsCount == hunk.rhsCount && hunk.lhsCount <= kShownLines ) {
+        for( size_t j = 0; j < hunk.lhsCount; ++j )
+          appendLinePair( out, lhs.line( hunk.lhsBegin + j ), rhs.line( hunk.rhsBegin + j ) );
+      } else {
+        appendLines( out, "-", lhs, hunk.lhsBegin, hunk.lhsCount );
+        appendLines( out, "+", rhs, hunk.rhsBegin, hunk.rhsCount );
+      }
+      position = hunk.lhsBegin + hunk.lhsCount;
+    }
+    appendLines( out, " ", lhs, position, after );
+    group = last + 1;
+  }
+  return out;
+}
+
+
+std::string stringSummary( const StringRef& aString ) {
+  size_t lines = 1;
+  for( const char* p = aString.data(); ( p = static_cast<const char*>( std::memchr( p, '\n', aString.size() - static_cast<size_t>( p - aString.data() ) ) ) ); ++p )
+    ++lines;
+  return "{ " + std::to_string( aString.size() ) + " bytes, " + std::to_string( lines ) + ( lines == 1 ? " line }" : " lines }" );
+}
+
+
+bool addStringDiff( ExpressionCapture& aCapture, const StringRef& aLhs, const StringRef& aRhs, const char* aOperator ) {
+  std::string diff = diffStrings( aLhs, aRhs );
+  if( diff.empty() )
+    return false;
+  aCapture.add( stringSummary( aLhs ) );
+  aCapture.add( std::string( "\"" ) + aOperator + "\"" );
+  aCapture.add( stringSummary( aRhs ) + diff );
+  return true;
+}
+
+} // namespace Detail
+
+} // namespace ACatch
@@ -0,0 +1,63 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+#if defined( _WIN32 )
+#  include <windows.h>
+#elif defined( __unix__ ) || defined( __APPLE__ )
+#  include <time.h>
+#else
+#  include <ctime>
+#endif
+
+namespace ACatch {
+
+namespace {
+
+double getWallSeconds() {
+  return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+} // namespace
+
+
+void Timer::start() {
+  mStartWall = getWallSeconds();
+  mStartCpu = getThreadCpuSeconds();
+}
+
+
+Timing Timer::getElapsed() const {
+  return Timing( getWallSeconds() - mStartWall, getThreadCpuSeconds() - mStartCpu );
+}
+
+
+double Timer::getThreadCpuSeconds() {
+#if defined( _WIN32 )
+  FILETIME creation, exit, kernel, user;
+  if( !GetThreadTimes( GetCurrentThread(), &creation, &exit, &kernel, &user ) )
+    return 0;
+  ULARGE_INTEGER k, u;
+  k.LowPart = kernel.dwLowDateTime;
+  k.HighPart = kernel.dwHighDateTime;
+  u.LowPart = user.dwLowDateTime;
+  u.HighPart = user.dwHighDateTime;
+  return static_cast<double>( k.QuadPart + u.QuadPart ) * 1e-7;
+#elif defined( __unix__ ) || defined( __APPLE__ )
+  timespec ts;
+  if( clock_gettime( CLOCK_THREAD_CPUTIME_ID, &ts ) != 0 )
+    return 0;
+  return static_cast<double>( ts.tv_sec ) + static_cast<double>( ts.tv_nsec ) * 1e-9;
+#else
+  // process cpu time as a fallback
+  return static_cast<double>( std::clock() ) / CLOCKS_PER_SEC;
+#endif
+}
+
+} // namespace ACatch
@@ -8,7 +8,18 @@
 
 #include "acatch/acatch_core.hpp"
 
-#include <iomanip>
+#include <cstdio>
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#  include <emmintrin.h>
+#  define ACATCH_INTERNAL_HAS_SSE2
+#endif
+
+#if __cplusplus >= 201703L && defined( __has_include )
+#  if __has_include( <charconv> )
+#    include <charconv>
+#  endif
+#endif
 
 namespace ACatch {
 
@@ -30,9 +41,186 @@ struct Endianness {
     return ( u.asChar[ sizeof( int ) - 1 ] == 1 ) ? Big : Little;
   }
 };
+
+const char kHexDigits[] = "0123456789abcdef";
+
+std::atomic<size_t> sMaxStringLength( 4096 );
+
+bool isControl( unsigned char aChar ) {
+  return aChar < 0x20 || aChar == 0x7f;
 }
 
-std::string rawMemoryToString( const void* object, std::size_t size ) {
+/// Index of the first control character of [aBegin, aEnd), aEnd if none. 16
+/// bytes are tested at once with SSE2.
+size_t findControl( const char* aData, size_t aBegin, size_t aEnd ) {
+  size_t i = aBegin;
+#ifdef ACATCH_INTERNAL_HAS_SSE2
+  const __m128i limit = _mm_set1_epi8( 0x1f );
+  const __m128i del = _mm_set1_epi8( 0x7f );
+  for( ; i + 16 <= aEnd; i += 16 ) {
+    __m128i chars = _mm_loadu_si128( reinterpret_cast<const __m128i*>( aData + i ) );
+    __m128i control = _mm_or_si128( _mm_cmpeq_epi8( _mm_min_epu8( chars, limit ), chars ), _mm_cmpeq_epi8( chars, del ) );
+    int mask = _mm_movemask_epi8( control );
+    if( mask ) {
+      for( ; !( mask & 1 ); mask >>= 1 )
+        ++i;
+      return i;
+    }
+  }
+#endif
+  for( ; i < aEnd; ++i ) {
+    if( isControl( static_cast<unsigned char>( aData[ i ] ) ) )
+      return i;
+  }
+  return aEnd;
+}
+
+} // namespace
+
+
+/// Append [aBegin, aEnd) with the control characters escaped, in a single pass
+void appendEscaped( StringSink& aSink, const char* aData, size_t aBegin, size_t aEnd ) {
+  while( aBegin < aEnd ) {
+    size_t control = findControl( aData, aBegin, aEnd );
+    aSink.append( aData + aBegin, control - aBegin );
+    if( control == aEnd )
+      break;
+    unsigned char c = static_cast<unsigned char>( aData[ control ] );
+    switch( c ) {
+    case '\n':
+      aSink << "\\n";
+      break;
+    case '\t':
+      aSink << "\\t";
+      break;
+    case '\r':
+      aSink << "\\r";
+      break;
+    default:
+      aSink << "\\x" << kHexDigits[ c >> 4 ] << kHexDigits[ c & 0xf ];
+      break;
+    }
+    aBegin = control + 1;
+  }
+}
+
+
+namespace {
+
+/// Quoted and escaped, the middle of a string longer than the maximum length
+/// is elided
+void appendQuoted( StringSink& aSink, const char* aData, size_t aSize ) {
+  size_t maxLength = sMaxStringLength.load( std::memory_order_relaxed );
+  aSink << '"';
+  if( maxLength == 0 || aSize <= maxLength ) {
+    appendEscaped( aSink, aData, 0, aSize );
+    aSink << '"';
+    return;
+  }
+  size_t head = maxLength - maxLength / 2;
+  size_t tail = maxLength / 2;
+  appendEscaped( aSink, aData, 0, head );
+  aSink << "\"...\"";
+  appendEscaped( aSink, aData, aSize - tail, aSize );
+  aSink << "\" (" << std::to_string( aSize - maxLength ) << " of " << std::to_string( aSize ) << " bytes elided)";
+}
+
+/// Stream buffer appending to the buffer of a sink
+class SinkBuffer : public std::streambuf
+{
+public:
+  SinkBuffer()
+      : mTarget( nullptr ) {
+  }
+
+  void setTarget( std::string* aTarget ) {
+    mTarget = aTarget;
+  }
+
+protected:
+  int_type overflow( int_type aChar ) override {
+    if( !traits_type::eq_int_type( aChar, traits_type::eof() ) )
+      mTarget->push_back( traits_type::to_char_type( aChar ) );
+    return traits_type::not_eof( aChar );
+  }
+
+  std::streamsize xsputn( const char* aData, std::streamsize aSize ) override {
+    mTarget->append( aData, static_cast<size_t>( aSize ) );
+    return aSize;
+  }
+
+private:
+  std::string* mTarget;
+};
+
+/// The stream of a thread, created once
+struct ThreadStream {
+  SinkBuffer buffer;
+  std::ostream stream;
+  bool busy;
+
+  ThreadStream()
+      : stream( &buffer )
+      , busy( false ) {
+  }
+};
+
+template <typename T>
+void appendUnsigned( StringSink& aSink, T aValue ) {
+  char digits[ 24 ];
+  char* end = digits + sizeof( digits );
+#ifdef __cpp_lib_to_chars
+  end = std::to_chars( digits, end, aValue ).ptr;
+  aSink.append( digits, static_cast<size_t>( end - digits ) );
+#else
+  char* p = end;
+  do {
+    *--p = static_cast<char>( '0' + aValue % 10 );
+    aValue /= 10;
+  } while( aValue );
+  aSink.append( p, static_cast<size_t>( end - p ) );
+#endif
+}
+
+template <typename T>
+void appendHex( StringSink& aSink, T aValue ) {
+  char digits[ 2 * sizeof( T ) ];
+  char* end = digits + sizeof( digits );
+  char* p = end;
+  do {
+    *--p = kHexDigits[ aValue & 0xf ];
+    aValue >>= 4;
+  } while( aValue );
+  aSink.append( p, static_cast<size_t>( end - p ) );
+}
+
+/// Fixed notation with aPrecision decimals, the trailing zeros are removed
+/// but one after the point
+template <typename T>
+void appendFixed( StringSink& aSink, T aValue, int aPrecision ) {
+  char digits[ 512 ]; // the largest double has 309 digits before the point
+  size_t size;
+#ifdef __cpp_lib_to_chars
+  size = static_cast<size_t>( std::to_chars( digits, digits + sizeof( digits ), aValue, std::chars_format::fixed, aPrecision ).ptr - digits );
+#else
+  int written = std::snprintf( digits, sizeof( digits ), "%.*f", aPrecision, static_cast<double>( aValue ) );
+  size = written < 0 ? 0 : static_cast<size_t>( written );
+#endif
+  size_t last = size;
+  while( last > 0 && digits[ last - 1 ] == '0' )
+    --last;
+  if( last > 0 && last < size ) {
+    if( digits[ last - 1 ] == '.' )
+      ++last;
+    size = last;
+  }
+  aSink.append( digits, size );
+}
+
+} // namespace
+
+
+void appendRawMemory( StringSink& aSink, const void* object, std::size_t size ) {
   // Reverse order for little endian architectures
   int i = 0, end = static_cast<int>( size ), inc = 1;
   if( Endianness::which() == Endianness::Little ) {
@@ -41,125 +229,226 @@ std::string rawMemoryToString( const void* object, std::size_t size ) {
   }
 
   unsigned char const* bytes = static_cast<unsigned char const*>( object );
-  std::ostringstream os;
-  os << "0x" << std::setfill( '0' ) << std::hex;
-  for( ; i != end; i += inc )
-    os << std::setw( 2 ) << static_cast<unsigned>( bytes[ i ] );
-  return os.str();
+  aSink << "0x";
+  for( ; i != end; i += inc ) {
+    aSink << kHexDigits[ bytes[ i ] >> 4 ];
+    aSink << kHexDigits[ bytes[ i ] & 0xf ];
+  }
 }
-} // namespace Detail
 
-std::string toString( std::string const& value ) {
-  std::string s = value;
-  // if( getCurrentContext().getConfig()->showInvisibles() )
-  {
-    for( size_t i = 0; i < s.size(); ++i ) {
-      std::string subs;
-      switch( s[ i ] ) {
-      case '\n':
-        subs = "\\n";
-        break;
-      case '\t':
-        subs = "\\t";
-        break;
-      default:
-        break;
-      }
-      if( !subs.empty() ) {
-        s = s.substr( 0, i ) + subs + s.substr( i + 1 );
-        ++i;
-      }
-    }
+
+std::string rawMemoryToString( const void* object, std::size_t size ) {
+  std::string s;
+  StringSink sink( s );
+  appendRawMemory( sink, object, size );
+  return s;
+}
+
+
+void streamToSink( StringSink& aSink, void ( *aWrite )( std::ostream&, const void* ), const void* aValue ) {
+  static thread_local ThreadStream sStream;
+  if( sStream.busy ) {
+    SinkBuffer buffer;
+    buffer.setTarget( &aSink.buffer() );
+    std::ostream stream( &buffer );
+    aWrite( stream, aValue );
+    return;
   }
-  return "\"" + s + "\"";
+
+  struct Release {
+    ~Release() {
+      sStream.buffer.setTarget( nullptr );
+      sStream.busy = false;
+    }
+  } release;
+  sStream.busy = true;
+  sStream.buffer.setTarget( &aSink.buffer() );
+  std::ostream& stream = sStream.stream;
+  stream.clear();
+  stream.flags( std::ios_base::skipws | std::ios_base::dec );
+  stream.precision( 6 );
+  stream.width( 0 );
+  stream.fill( ' ' );
+  aWrite( stream, aValue );
 }
-std::string toString( std::wstring const& value ) {
 
+} // namespace Detail
+
+
+void setMaxStringLength( size_t aLength ) {
+  Detail::sMaxStringLength.store( aLength, std::memory_order_relaxed );
+}
+
+size_t getMaxStringLength() {
+  return Detail::sMaxStringLength.load( std::memory_order_relaxed );
+}
+
+void appendString( StringSink& aSink, std::string const& value ) {
+  Detail::appendQuoted( aSink, value.data(), value.size() );
+}
+
+void appendString( StringSink& aSink, std::wstring const& value ) {
   std::string s;
   s.reserve( value.size() );
   for( size_t i = 0; i < value.size(); ++i )
     s += value[ i ] <= 0xff ? static_cast<char>( value[ i ] ) : '?';
-  return ::ACatch::toString( s );
+  appendString( aSink, s );
+}
+
+void appendString( StringSink& aSink, const char* const value ) {
+  if( value )
+    Detail::appendQuoted( aSink, value, std::strlen( value ) );
+  else
+    aSink << "{null string}";
+}
+
+void appendString( StringSink& aSink, char* const value ) {
+  appendString( aSink, static_cast<const char*>( value ) );
+}
+
+void appendString( StringSink& aSink, const wchar_t* const value ) {
+  if( value )
+    appendString( aSink, std::wstring( value ) );
+  else
+    aSink << "{null string}";
+}
+
+void appendString( StringSink& aSink, wchar_t* const value ) {
+  appendString( aSink, static_cast<const wchar_t*>( value ) );
+}
+
+void appendString( StringSink& aSink, int value ) {
+  if( value < 0 ) {
+    aSink << '-';
+    Detail::appendUnsigned( aSink, 0u - static_cast<unsigned int>( value ) );
+  } else {
+    Detail::appendUnsigned( aSink, static_cast<unsigned int>( value ) );
+  }
+  if( value >= 255 ) {
+    aSink << " (0x";
+    Detail::appendHex( aSink, static_cast<unsigned int>( value ) );
+    aSink << ')';
+  }
+}
+
+void appendString( StringSink& aSink, unsigned long value ) {
+  Detail::appendUnsigned( aSink, value );
+  if( value >= 255 ) {
+    aSink << " (0x";
+    Detail::appendHex( aSink, value );
+    aSink << ')';
+  }
+}
+
+void appendString( StringSink& aSink, unsigned int value ) {
+  appendString( aSink, static_cast<unsigned long>( value ) );
+}
+
+void appendString( StringSink& aSink, const double value ) {
+  Detail::appendFixed( aSink, value, 10 );
+}
+
+void appendString( StringSink& aSink, const float value ) {
+  Detail::appendFixed( aSink, value, 5 );
+  aSink << 'f';
+}
+
+void appendString( StringSink& aSink, bool value ) {
+  aSink << ( value ? "true" : "false" );
+}
+
+void appendString( StringSink& aSink, char value ) {
+  if( value < ' ' )
+    appendString( aSink, static_cast<unsigned int>( value ) );
+  else
+    aSink << value;
+}
+
+void appendString( StringSink& aSink, signed char value ) {
+  appendString( aSink, static_cast<char>( value ) );
+}
+
+void appendString( StringSink& aSink, unsigned char value ) {
+  appendString( aSink, static_cast<char>( value ) );
+}
+
+void appendString( StringSink& aSink, std::nullptr_t ) {
+  aSink << "nullptr";
+}
+
+namespace {
+
+/// The toString overloads are wrappers of the sink conversions
+template <typename T>
+std::string sinkToString( T value ) {
+  std::string s;
+  StringSink sink( s );
+  appendString( sink, value );
+  return s;
+}
+
+} // namespace
+
+std::string toString( std::string const& value ) {
+  return sinkToString<std::string const&>( value );
+}
+std::string toString( std::wstring const& value ) {
+  return sinkToString<std::wstring const&>( value );
 }
 
 std::string toString( const char* const value ) {
-  return value ? ::ACatch::toString( std::string( value ) )
-               : std::string( "{null string}" );
+  return sinkToString( value );
 }
 
 std::string toString( char* const value ) {
-  return ::ACatch::toString( static_cast<const char*>( value ) );
+  return sinkToString( value );
 }
 
 std::string toString( const wchar_t* const value ) {
-  return value ? ::ACatch::toString( std::wstring( value ) )
-               : std::string( "{null string}" );
+  return sinkToString( value );
 }
 
 std::string toString( wchar_t* const value ) {
-  return ::ACatch::toString( static_cast<const wchar_t*>( value ) );
+  return sinkToString( value );
 }
 
 std::string toString( int value ) {
-  std::ostringstream oss;
-  oss << value;
-  if( value >= 255 )
-    oss << " (0x" << std::hex << value << ")";
-  return oss.str();
+  return sinkToString( value );
 }
 
 std::string toString( unsigned long value ) {
-  std::ostringstream oss;
-  oss << value;
-  if( value >= 255 )
-    oss << " (0x" << std::hex << value << ")";
-  return oss.str();
+  return sinkToString( value );
 }
 
 std::string toString( unsigned int value ) {
-  return ::ACatch::toString( static_cast<unsigned long>( value ) );
-}
-
-template <typename T>
-std::string fpToString( T value, int precision ) {
-  std::ostringstream oss;
-  oss << std::setprecision( precision ) << std::fixed << value;
-  std::string d = oss.str();
-  std::size_t i = d.find_last_not_of( '0' );
-  if( i != std::string::npos && i != d.size() - 1 ) {
-    if( d[ i ] == '.' )
-      i++;
-    d = d.substr( 0, i + 1 );
-  }
-  return d;
+  return sinkToString( value );
 }
 
 std::string toString( const double value ) {
-  return fpToString( value, 10 );
+  return sinkToString( value );
 }
 std::string toString( const float value ) {
-  return fpToString( value, 5 ) + "f";
+  return sinkToString( value );
 }
 
 std::string toString( bool value ) {
-  return value ? "true" : "false";
+  return sinkToString( value );
 }
 
 std::string toString( char value ) {
-  return value < ' ' ? toString( static_cast<unsigned int>( value ) )
-                     : Detail::makeString( value );
+  return sinkToString( value );
 }
 
 std::string toString( signed char value ) {
-  return toString( static_cast<char>( value ) );
+  return sinkToString( value );
 }
 
 std::string toString( unsigned char value ) {
-  return toString( static_cast<char>( value ) );
+  return sinkToString( value );
 }
 
 std::string toString( std::nullptr_t ) {
-  return "nullptr";
+  return sinkToString( nullptr );
 }
 
 } // namespace ACatch
@@ -0,0 +1,76 @@
+/*
+ *  Based on the work of Phil, Copyright 2010 Two Blue Cubes Ltd. All rights
+ * reserved.
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+
+#include "acatch/acatch_core.hpp"
+
+namespace ACatch {
+
+Watchdog::Watchdog()
+    : mStop( false ) {
+}
+
+
+Watchdog::~Watchdog() {
+  {
+    std::lock_guard<std::mutex> lg( mMutex );
+    mStop = true;
+  }
+  mWakeUp.notify_all();
+  if( mThread.joinable() )
+    mThread.join();
+}
+
+
+void Watchdog::arm( RunContext& aContext, const TestCaseInfo& aInfo, double aSeconds ) {
+  Entry entry;
+  entry.info = &aInfo;
+  entry.seconds = aSeconds;
+  entry.deadline = std::chrono::steady_clock::now()
+                   + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                       std::chrono::duration<double>( aSeconds ) );
+  {
+    std::lock_guard<std::mutex> lg( mMutex );
+    mEntries[ &aContext ] = entry;
+    if( !mThread.joinable() )
+      mThread = std::thread( &Watchdog::watch, this );
+  }
+  mWakeUp.notify_all();
+}
+
+
+void Watchdog::disarm( RunContext& aContext ) {
+  std::lock_guard<std::mutex> lg( mMutex );
+  mEntries.erase( &aContext );
+}
+
+
+void Watchdog::watch() {
+  std::unique_lock<std::mutex> lock( mMutex );
+  while( !mStop ) {
+    auto next = mEntries.end();
+    for( auto it = mEntries.begin(); it != mEntries.end(); ++it ) {
+      if( next == mEntries.end() || it->second.deadline < next->second.deadline )
+        next = it;
+    }
+
+    if( next == mEntries.end() ) {
+      mWakeUp.wait( lock );
+    } else if( next->second.deadline > std::chrono::steady_clock::now() ) {
+      mWakeUp.wait_until( lock, next->second.deadline );
+    } else {
+      // the process is terminated, the test case cannot be stopped in any other way;
+      // the lock is kept so that the test cannot be disarmed and its context destroyed
+      RunContext& ctx = *next->first;
+      Entry entry = next->second;
+      mEntries.erase( next );
+      theACatch().handleTimeout( ctx, *entry.info, entry.seconds );
+    }
+  }
+}
+
+} // namespace ACatch